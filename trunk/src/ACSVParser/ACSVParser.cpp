@@ -24,16 +24,242 @@
 #include <iterator>
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace acsvparser;
 
+namespace
+{
+    /// Minimum number of rows or values for which work is split across 
+    /// threads. Smaller inputs are not worth the threading overhead.
+    const long ParallelRowThreshold = 4096;
+
+    /// Retrieves the value of a numeric cell as a double.
+    /// Returns false for cells that are not numeric.
+    inline bool GetNumericValue(const ACSVParser::TypeData &typeData, 
+        double &value)
+    {
+        switch( typeData.GetType() )
+        {
+        case ACSVParser::TYPE_UINT:
+            value = typeData.GetUInt();
+            return true;
+        case ACSVParser::TYPE_INT:
+            value = typeData.GetInt();
+            return true;
+        case ACSVParser::TYPE_FLOAT:
+            value = typeData.GetFloat();
+            return true;
+        case ACSVParser::TYPE_DOUBLE:
+            value = typeData.GetDouble();
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /// Computes summary statistics over a contiguous array of values.
+    /// The array must not be empty.
+    void ComputeStats(const double * const pValues, const long count,
+        ACSVParser::ColumnStats &stats)
+    {
+        double sum = 0.0;
+        double minValue = pValues[0];
+        double maxValue = pValues[0];
+
+#pragma omp parallel if(count > ParallelRowThreshold)
+        {
+            double localMin = pValues[0];
+            double localMax = pValues[0];
+
+#pragma omp for schedule(static) reduction(+:sum)
+            for(long i = 0; i < count; ++i)
+            {
+                const double value = pValues[i];
+                sum += value;
+                localMin = (value < localMin) ? value : localMin;
+                localMax = (value > localMax) ? value : localMax;
+            }
+
+#pragma omp critical
+            {
+                if( localMin < minValue )
+                    minValue = localMin;
+                if( localMax > maxValue )
+                    maxValue = localMax;
+            }
+        }
+
+        stats.count = static_cast<ACSVParser::DataSizeType>(count);
+        stats.sum = sum;
+        stats.min = minValue;
+        stats.max = maxValue;
+        stats.mean = sum / count;
+    }
+
+    /// Counts a contiguous array of values into equal width bins spanning
+    /// the range [minValue, maxValue].
+    void ComputeHistogram(const double * const pValues, const long count,
+        const double minValue, const double maxValue,
+        std::vector<ACSVParser::DataSizeType> &bins)
+    {
+        const long noOfBins = static_cast<long>(bins.size());
+        const double scale = (maxValue > minValue) ? 
+            noOfBins / (maxValue - minValue) : 0.0;
+
+#pragma omp parallel if(count > ParallelRowThreshold)
+        {
+            std::vector<ACSVParser::DataSizeType> localBins(bins.size(), 0);
+
+#pragma omp for schedule(static)
+            for(long i = 0; i < count; ++i)
+            {
+                // Non-finite values fall in no bin.
+                const double position = (pValues[i] - minValue) * scale;
+                if( !(position == position) || 
+                    pValues[i] - pValues[i] != 0.0 )
+                    continue;
+
+                long bin = 0;
+                if( position >= noOfBins )
+                    bin = noOfBins - 1;
+                else if( position > 0.0 )
+                    bin = static_cast<long>(position);
+                ++localBins[bin];
+            }
+
+#pragma omp critical
+            {
+                for(long j = 0; j < noOfBins; ++j)
+                    bins[j] += localBins[j];
+            }
+        }
+    }
+
+    /// Converts a single buffer element to a character without 
+    /// sign extension.
+    inline ACSVParser::StringValueType ToToken(const char c)
+    { 
+        return static_cast<ACSVParser::StringValueType>(
+            static_cast<unsigned char>(c)); 
+    }
+
+    inline ACSVParser::StringValueType ToToken(const wchar_t c)
+    { return c; }
+
+    /// Reads the character at a position of a buffer depending on the
+    /// encoding.
+    template <typename CharType>
+    inline ACSVParser::StringValueType ReadToken(
+        const CharType * const pStrContent, const std::streamsize i, 
+        const unsigned int byteSize, const ACSVParser::Encoding encoding)
+    {
+        ACSVParser::StringValueType token = ToToken(pStrContent[i]);
+        if( byteSize == 2 )
+        {                
+            if( encoding == ACSVParser::ENC_UTF16LE )
+            {
+                token = token | (ToToken(pStrContent[i + 1]) << (2 << byteSize));
+            }
+            else if( encoding == ACSVParser::ENC_UTF16BE )
+            {
+                token = (token << (2 << byteSize)) | ToToken(pStrContent[i + 1]);
+            }
+        }
+
+        return token;
+    }
+
+    /// Appends a range of single element characters to a string.
+    inline void AppendTokens(ACSVParser::StringType &str, 
+        const char * const pFirst, const char * const pLast)
+    {
+        for(const char *pToken = pFirst; pToken != pLast; ++pToken)
+            str += ToToken(*pToken);
+    }
+
+    inline void AppendTokens(ACSVParser::StringType &str, 
+        const wchar_t * const pFirst, const wchar_t * const pLast)
+    { str.append(pFirst, pLast); }
+
+    /// Size of the buffer used instead of slurping when a memory budget
+    /// is set. Kept even so UTF-16 characters are not split.
+    const std::streamsize BudgetBufferSize = 1024 * 1024;
+
+    /// Number of rows in a block spilled to disk.
+    const ACSVParser::DataSizeType SpillBlockRows = 4096;
+
+    /// Creates a new empty file that only the current user can access. 
+    /// Fails if anything, including a symbolic link, already exists at 
+    /// the path, in which case doesExist is set.
+    bool CreateNewFile(const std::string &fileName, bool &doesExist)
+    {
+#ifdef _WIN32
+        const int fd = _open(fileName.c_str(), 
+            _O_CREAT | _O_EXCL | _O_RDWR | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        const int fd = open(fileName.c_str(), 
+            O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+#endif
+        doesExist = (fd == -1 && errno == EEXIST);
+        if( fd == -1 )
+            return false;
+
+#ifdef _WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+        return true;
+    }
+
+    /// Maximum number of characters sampled when detecting the dialect.
+    const std::streamsize DialectSampleSize = 64 * 1024;
+
+    /// Number of leading characters that identify a file parsed 
+    /// incrementally.
+    const std::streamsize TailSignatureSize = 512;
+
+    /// Reads up to size characters from the start of a file.
+    ACSVParser::StringType ReadLeadingContent(
+        ACSVParser::InputFileStreamType &inFile, const std::streamsize size)
+    {
+        ACSVParser::StringType content;
+        if( size <= 0 )
+            return content;
+
+        std::vector<ACSVParser::StringValueType> buffer(
+            static_cast<std::size_t>(size));
+        inFile.clear();
+        inFile.seekg(0, std::ios::beg);
+        inFile.read(&buffer[0], size);
+        content.assign(&buffer[0], static_cast<std::size_t>(inFile.gcount()));
+        inFile.clear();
+
+        return content;
+    }
+}
+
 const bool ACSVParser::ParseFile(const std::string &fileName, 
     const std::streamsize bufferSize)
 {
     ResetState();
+    _tailFileName.clear();
 
-    bool result = true;
-    InputFileStreamType inFile(fileName);
+    // Binary mode keeps offsets in the content equal to file offsets.
+    // Carriage returns are skipped by the parser.
+    InputFileStreamType inFile(fileName, 
+        std::ios::in | std::ios::binary);
     if ( !inFile )
     {
         _errorState = ERRORSTATE_FAILED_TO_OPEN_FILE;
@@ -41,29 +267,170 @@ const bool ACSVParser::ParseFile(const std::string &fileName,
     }
     
     const Encoding encoding = GetEncoding(inFile);
+    if( _shouldDetectDialect )
+        DetectDialect(inFile, encoding);
+    _isByteContent = (encoding == ENC_UTF8);
+
+    ParseState parseState;
+    parseState.startOffset = inFile.tellg();
+    parseState.offset = parseState.startOffset;
+    ClearData();
+    if( !ParseStream(inFile, bufferSize, parseState, encoding) )
+        return false;
+
+    return FinishParse(parseState);
+}
+
+const bool ACSVParser::ParseFileIncremental(const std::string &fileName, 
+    const std::streamsize bufferSize)
+{
+    ResetState();
+
+    InputFileStreamType inFile(fileName, 
+        std::ios::in | std::ios::binary);
+    if ( !inFile )
+    {
+        _errorState = ERRORSTATE_FAILED_TO_OPEN_FILE;
+        return false;
+    }
+
+    inFile.seekg(0, std::ios::end);
+    const std::streamoff fileSize = inFile.tellg();
+
+    // Start over if this is a different file, or if it has been truncated
+    // or replaced. A replaced file is told apart by its leading content.
+    bool isSameFile = (fileName == _tailFileName && fileSize >= _tailOffset);
+    if( isSameFile && !_tailSignature.empty() )
+    {
+        isSameFile = (ReadLeadingContent(inFile, 
+            static_cast<std::streamsize>(_tailSignature.size())) == 
+            _tailSignature);
+    }
+
+    if( !isSameFile )
+    {
+        ClearData();
+        _tailState = ParseState();
+        _tailFileName = fileName;
+        _tailSignature.clear();
+
+        inFile.seekg(0, std::ios::beg);
+        _tailEncoding = GetEncoding(inFile);
+        if( _shouldDetectDialect )
+            DetectDialect(inFile, _tailEncoding);
+        _isByteContent = (_tailEncoding == ENC_UTF8);
+        _tailOffset = inFile.tellg();
+        _tailState.startOffset = _tailOffset;
+    }
+    else if( fileSize == _tailOffset )
+    {
+        // Nothing has been appended.
+        return true;
+    }
+    else
+    {
+        inFile.seekg(_tailOffset, std::ios::beg);
+    }
+
+    _tailState.offset = _tailOffset;
+    _vColumnCache.clear();
+
+    // Take back the trailing field if it was only flushed to make it visible.
+    if( _tailState.bDidFlushPendingData )
+    {
+        _vVData.back().pop_back();
+        _tailState.bDidFlushPendingData = false;
+    }
+
+    if( !ParseStream(inFile, bufferSize, _tailState, _tailEncoding) )
+    {
+        _tailFileName.clear();
+        return false;
+    }
+
+    FlushPendingData(_tailState);
+
+    inFile.clear();
+    _tailOffset = inFile.tellg();
+
+    // The parsed content is not expected to change, so its head 
+    // identifies the file in later calls.
+    const std::streamsize signatureSize = static_cast<std::streamsize>(
+        std::min<std::streamoff>(TailSignatureSize, _tailOffset));
+    if( static_cast<std::streamsize>(_tailSignature.size()) < signatureSize )
+        _tailSignature = ReadLeadingContent(inFile, signatureSize);
+
+    if( _hasTypeRow && GetRowCount() > 0 )
+    {
+        // Skip the trailing row since it may not be complete yet.
+        if( !ProcessDataTypes(_processedRowCount, GetRowCount() - 1) )
+        {
+            _tailFileName.clear();
+            return false;
+        }
+        _processedRowCount = GetRowCount() - 1;
+    }
+
+    return true;
+}
+
+const bool ACSVParser::HasNewData(const std::string &fileName) const
+{
+    if( fileName != _tailFileName )
+        return true;
+
+    InputFileStreamType inFile(fileName, 
+        std::ios::in | std::ios::binary);
+    if ( !inFile )
+        return false;
+
+    inFile.seekg(0, std::ios::end);
+    const std::streamoff fileSize = inFile.tellg();
+    if( fileSize != _tailOffset )
+        return true;
 
-    if( bufferSize != ACSVParser::Slurp )
+    // A file replaced by one of the same size.
+    return ReadLeadingContent(inFile, 
+        static_cast<std::streamsize>(_tailSignature.size())) != _tailSignature;
+}
+
+const bool ACSVParser::ParseStream(InputFileStreamType &inFile,
+                                   const std::streamsize bufferSize,
+                                   ParseState &parseState,
+                                   const Encoding encoding)
+{
+    bool result = true;
+    if( bufferSize != ACSVParser::Slurp || _memoryBudget )
     {
-        ParseState parseState;
+        // Slurping would hold the whole content in memory.
+        const std::streamsize actualBufferSize = 
+            (bufferSize != ACSVParser::Slurp) ? bufferSize : BudgetBufferSize;
         StringValueType * const pBuffer = 
-            new StringValueType[static_cast<unsigned int>(bufferSize)];
+            new StringValueType[static_cast<unsigned int>(actualBufferSize)];
         if( !pBuffer )
         {
             _errorState = ERRORSTATE_FAILED_TO_ALLOCATE_BUFFER;
             return false;
         }
 
-        _vVData.clear();
         while( !inFile.eof() )
         {
             std::streamsize sizeRead = 
-                inFile.read(pBuffer, bufferSize).gcount();
+                inFile.read(pBuffer, actualBufferSize).gcount();
+            if( sizeRead == 0 )
+                break;
 
             if( !ParseString(pBuffer, sizeRead, parseState, encoding) )
             {
                 result = false;
                 break;
             }
+
+            if( _memoryBudget && !EnforceMemoryBudget() )
+            {
+                result = false;
+                break;
+            }
         }
 
         if( pBuffer )
@@ -79,7 +446,11 @@ const bool ACSVParser::ParseFile(const std::string &fileName,
             std::back_insert_iterator<StringType>( strBuffer )
             );
 
-        if( !ParseString(strBuffer, encoding) )
+        if( !ParseString(strBuffer.c_str(), 
+                         strBuffer.length(), 
+                         parseState, 
+                         encoding) 
+          )
         {
             result = false;
         }
@@ -92,10 +463,22 @@ const bool ACSVParser::ParseString(const ACSVParser::StringType &strContent,
                                    const Encoding encoding)
 {
     ResetState();
-    _vVData.clear();
+    _tailFileName.clear();
+    ClearData();
+    _isByteContent = false;
+
+    if( _shouldDetectDialect )
+    {
+        DetectDialect(strContent.c_str(), 
+            std::min(static_cast<std::streamsize>(strContent.length()), 
+                     DialectSampleSize), 
+            encoding);
+    }
+
+    ParseState parseState;
     if( !ParseString(strContent.c_str(), 
                      strContent.length(), 
-                     ParseState(),
+                     parseState,
                      encoding
                     )
       )
@@ -103,53 +486,145 @@ const bool ACSVParser::ParseString(const ACSVParser::StringType &strContent,
         return false;
     }
 
-    return true;
+    return FinishParse(parseState);
 }
 
-const bool ACSVParser::ParseString(const StringValueType * const pStrContent, 
+const bool ACSVParser::ParseBuffer(const char * const pData,
+                                   const std::streamsize length,
+                                   const Encoding encoding)
+{
+    ResetState();
+    _tailFileName.clear();
+    ClearData();
+
+    // Detect and skip the BOM.
+    unsigned int bomSize = 0;
+    const Encoding bomEncoding = GetEncoding(
+        (length > 0) ? static_cast<unsigned char>(pData[0]) : 0,
+        (length > 1) ? static_cast<unsigned char>(pData[1]) : 0,
+        (length > 2) ? static_cast<unsigned char>(pData[2]) : 0,
+        bomSize);
+
+    Encoding actualEncoding = encoding;
+    if( encoding == ENC_AUTODETECT )
+        actualEncoding = bomEncoding;
+    else if( encoding != bomEncoding )
+        bomSize = 0;
+
+    if( _shouldDetectDialect )
+    {
+        DetectDialect(pData + bomSize, 
+            std::min(length - bomSize, DialectSampleSize), actualEncoding);
+    }
+    _isByteContent = (actualEncoding == ENC_UTF8);
+
+    ParseState parseState;
+    parseState.startOffset = bomSize;
+    parseState.offset = bomSize;
+    if( !ParseString(pData + bomSize, length - bomSize, parseState, 
+                     actualEncoding) )
+    {
+        return false;
+    }
+
+    return FinishParse(parseState);
+}
+
+const bool ACSVParser::ParseBuffer(const wchar_t * const pData,
+                                   const std::streamsize length)
+{
+    ResetState();
+    _tailFileName.clear();
+    ClearData();
+
+    // Characters are already decoded, so each is taken as is.
+    _isByteContent = false;
+    if( _shouldDetectDialect )
+        DetectDialect(pData, std::min(length, DialectSampleSize), ENC_UTF8);
+
+    ParseState parseState;
+    if( !ParseString(pData, length, parseState, ENC_UTF8) )
+        return false;
+
+    return FinishParse(parseState);
+}
+
+template <typename CharType>
+const bool ACSVParser::ParseString(const CharType * const pStrContent, 
                                    const std::streamsize bufferSize, 
                                    ParseState& parseState,
                                    const Encoding encoding)
 {
     const unsigned int byteSize = GetEncodingByteSize(encoding);
 
-    StringType strData;
-    for( StringType::size_type i = 0; i < bufferSize; i += byteSize)
+    // Content without text delimiters doesn't need to track them.
+    if( !parseState.bDidFindTextDelim && byteSize == 1 )
+    {
+        return ParseUnquotedString(pStrContent, bufferSize, parseState, 
+                                   encoding);
+    }
+
+    // Complete a character split by the end of the previous buffer.
+    if( parseState.bHasPendingByte && bufferSize > 0 )
+    {
+        const CharType character[2] = 
+            { static_cast<CharType>(parseState.pendingByte), pStrContent[0] };
+        parseState.bHasPendingByte = false;
+        if( !ParseString(character, 2, parseState, encoding) )
+            return false;
+        return ParseString(pStrContent + 1, bufferSize - 1, parseState, 
+                           encoding);
+    }
+
+    // Field content may span buffers, so continue with what is pending.
+    StringType &strData = parseState.strPendingData;
+    std::streamsize i = 0;
+    for( ; i + byteSize <= bufferSize; i += byteSize)
     {
         // Convert the token depending on the encoding.
-        StringValueType token = pStrContent[i];
-        if( byteSize == 2 )
-        {                
-            if( encoding == ENC_UTF16LE )
-            {
-                token = token | (pStrContent[i + 1] << (2 << byteSize));
-            }
-            else if( encoding == ENC_UTF16BE )
+        const StringValueType token = 
+            ReadToken(pStrContent, i, byteSize, encoding);
+
+        if( parseState.bIsTextDelimPending )
+        {
+            parseState.bIsTextDelimPending = false;
+            if( token == _textDelim )
             {
-                token = (token << (2 << byteSize)) | pStrContent[i + 1];
+                strData += token;
+                continue;
             }
-        }        
+            parseState.bDidBeginTextDelim = false;
+        }
 
         // Skip carriage return
-        if( token == L'\r' )
+        if( token == L'\r' && _shouldSkipCarriageReturns )
             continue;
 
         if( token == _textDelim )
         {
             // Skip and record escaped text delimiters.
-            if( i < (bufferSize - 1) && pStrContent[i + 1] == _textDelim )
+            if( parseState.bDidBeginTextDelim && 
+                i + 2 * byteSize > bufferSize )
+            {
+                parseState.bIsTextDelimPending = true;
+            }
+            else if( parseState.bDidBeginTextDelim && 
+                ReadToken(pStrContent, i + byteSize, byteSize, encoding) == 
+                    _textDelim )
             {
                 strData += token;
-                ++i;
+                i += byteSize;
+            }
+            else
+            {
+                parseState.bDidBeginTextDelim = !parseState.bDidBeginTextDelim;
             }
-
-            parseState.bDidBeginTextDelim = !parseState.bDidBeginTextDelim;
         }
         else if( token == _separator && !parseState.bDidBeginTextDelim )
         {
             if( _vVData.empty() )
             {
-                _vVData.push_back(RowDataType());
+                BeginRow(parseState.startOffset);
             }
             _vVData.back().push_back(TypeData(strData));
             strData.clear();
@@ -161,13 +636,13 @@ const bool ACSVParser::ParseString(const StringValueType * const pStrContent,
             {
                 if( _vVData.empty() )
                 {
-                    _vVData.push_back(RowDataType());
+                    BeginRow(parseState.startOffset);
                 }
                 _vVData.back().push_back(TypeData(strData));
                 strData.clear();
             }
 
-            _vVData.push_back(RowDataType());
+            BeginRow(parseState.offset + i + byteSize);
         }
         else
         {
@@ -175,22 +650,527 @@ const bool ACSVParser::ParseString(const StringValueType * const pStrContent,
         }
     }
 
-    if( !strData.empty() )
+    // Keep the first byte of a character that continues in the next buffer.
+    if( i < bufferSize )
     {
-        if( _vVData.empty() )
+        parseState.bHasPendingByte = true;
+        parseState.pendingByte = ToToken(pStrContent[i]);
+    }
+
+    parseState.offset += i;
+
+    return true;
+}
+
+template <typename CharType>
+const bool ACSVParser::ParseUnquotedString(const CharType * const pStrContent, 
+                                           const std::streamsize bufferSize, 
+                                           ParseState& parseState,
+                                           const Encoding encoding)
+{
+    // Field content is appended a whole run of characters at a time.
+    StringType &strData = parseState.strPendingData;
+    std::streamsize fieldBegin = 0;
+    for( std::streamsize i = 0; i < bufferSize; ++i)
+    {
+        const StringValueType token = ToToken(pStrContent[i]);
+        if( token == L'\r' && _shouldSkipCarriageReturns )
+        {
+            AppendTokens(strData, pStrContent + fieldBegin, pStrContent + i);
+            fieldBegin = i + 1;
+        }
+        else if( token == _textDelim )
         {
-            _vVData.push_back(RowDataType());
+            // Hand the rest of the content over to the full parser.
+            AppendTokens(strData, pStrContent + fieldBegin, pStrContent + i);
+            parseState.bDidFindTextDelim = true;
+            parseState.offset += i;
+            return ParseString(pStrContent + i, bufferSize - i, parseState, 
+                               encoding);
+        }
+        else if( token == _separator )
+        {
+            AppendTokens(strData, pStrContent + fieldBegin, pStrContent + i);
+            fieldBegin = i + 1;
+
+            if( _vVData.empty() )
+            {
+                BeginRow(parseState.startOffset);
+            }
+            _vVData.back().push_back(TypeData(strData));
+            strData.clear();
+        }
+        else if( token == _recordSeparator )
+        {
+            AppendTokens(strData, pStrContent + fieldBegin, pStrContent + i);
+            fieldBegin = i + 1;
+
+            if( !strData.empty() )
+            {
+                if( _vVData.empty() )
+                {
+                    BeginRow(parseState.startOffset);
+                }
+                _vVData.back().push_back(TypeData(strData));
+                strData.clear();
+            }
+
+            BeginRow(parseState.offset + i + 1);
         }
-        _vVData.back().push_back(TypeData(strData));
     }
 
+    AppendTokens(strData, pStrContent + fieldBegin, pStrContent + bufferSize);
+    parseState.offset += bufferSize;
+
+    return true;
+}
+
+template <typename CharType>
+void ACSVParser::DetectDialect(const CharType * const pSample,
+                               const std::streamsize sampleSize,
+                               const Encoding encoding)
+{
+    if( GetEncodingByteSize(encoding) != 1 )
+        return;
+
+    // Detect the line ending.
+    DataSizeType noOfCRLF = 0, noOfLF = 0, noOfCR = 0;
+    for( std::streamsize i = 0; i < sampleSize; ++i )
+    {
+        const StringValueType token = ToToken(pSample[i]);
+        if( token == L'\n' )
+        {
+            ++noOfLF;
+        }
+        else if( token == L'\r' && i + 1 < sampleSize )
+        {
+            if( ToToken(pSample[i + 1]) == L'\n' )
+            {
+                ++noOfCRLF;
+                ++i;
+            }
+            else
+            {
+                ++noOfCR;
+            }
+        }
+    }
+
+    if( noOfCR > 0 && noOfLF == 0 && noOfCRLF == 0 )
+    {
+        _recordSeparator = L'\r';
+        _shouldSkipCarriageReturns = false;
+    }
+    else if( noOfLF > 0 || noOfCRLF > 0 )
+    {
+        _recordSeparator = L'\n';
+        _shouldSkipCarriageReturns = (noOfCRLF > 0);
+    }
+
+    // Split the sample into lines. The last line may have been cut short
+    // by the sample size, so it is only used if it is the only one.
+    std::vector<std::pair<std::streamsize, std::streamsize> > lines;
+    std::streamsize lineBegin = 0;
+    for( std::streamsize i = 0; i < sampleSize; ++i )
+    {
+        if( ToToken(pSample[i]) == _recordSeparator )
+        {
+            lines.push_back(std::make_pair(lineBegin, i));
+            lineBegin = i + 1;
+        }
+    }
+    if( lines.empty() && sampleSize > 0 )
+        lines.push_back(std::make_pair(static_cast<std::streamsize>(0), 
+                                       sampleSize));
+    if( lines.empty() )
+        return;
+
+    // Pick the separator that occurs the same number of times (outside 
+    // double quotes) on the most lines. Lines without it count against it,
+    // so it must be consistent on most lines to replace the separator set
+    // by the user.
+    const StringValueType separators[] = { L',', L'\t', L';', L'|' };
+    const int noOfSeparators = sizeof(separators) / sizeof(separators[0]);
+    DataSizeType bestConsistency = 0, bestCount = 0;
+    for( int k = 0; k < noOfSeparators; ++k )
+    {
+        std::vector<DataSizeType> counts;
+        for( std::vector<std::pair<std::streamsize, std::streamsize> >::
+             size_type j = 0; j < lines.size(); ++j )
+        {
+            DataSizeType count = 0;
+            bool isQuoted = false;
+            for( std::streamsize i = lines[j].first; i < lines[j].second; ++i )
+            {
+                const StringValueType token = ToToken(pSample[i]);
+                if( token == L'\"' )
+                    isQuoted = !isQuoted;
+                else if( token == separators[k] && !isQuoted )
+                    ++count;
+            }
+            counts.push_back(count);
+        }
+
+        // Find the most common non-zero count.
+        std::sort(counts.begin(), counts.end());
+        DataSizeType consistency = 0, count = 0;
+        for( std::vector<DataSizeType>::size_type j = 0; j < counts.size(); )
+        {
+            std::vector<DataSizeType>::size_type end = j;
+            while( end < counts.size() && counts[end] == counts[j] )
+                ++end;
+            if( counts[j] > 0 && end - j >= consistency )
+            {
+                consistency = end - j;
+                count = counts[j];
+            }
+            j = end;
+        }
+        if( consistency * 2 <= lines.size() )
+            continue;
+
+        if( consistency > bestConsistency || 
+            (consistency == bestConsistency && count > bestCount) )
+        {
+            bestConsistency = consistency;
+            bestCount = count;
+            _separator = separators[k];
+        }
+    }
+
+    // Pick the text delimiter that begins the most fields.
+    const StringValueType textDelims[] = { L'\"', L'\'' };
+    DataSizeType bestFields = 0;
+    for( int k = 0; k < 2; ++k )
+    {
+        DataSizeType noOfFields = 0;
+        for( std::vector<std::pair<std::streamsize, std::streamsize> >::
+             size_type j = 0; j < lines.size(); ++j )
+        {
+            for( std::streamsize i = lines[j].first; i < lines[j].second; ++i )
+            {
+                const bool isFieldBegin = (i == lines[j].first) || 
+                    ToToken(pSample[i - 1]) == _separator;
+                if( isFieldBegin && ToToken(pSample[i]) == textDelims[k] )
+                    ++noOfFields;
+            }
+        }
+
+        if( noOfFields > bestFields )
+        {
+            bestFields = noOfFields;
+            _textDelim = textDelims[k];
+        }
+    }
+}
+
+void ACSVParser::DetectDialect(InputFileStreamType &inFile,
+                               const Encoding encoding)
+{
+    const std::streampos lastPos = inFile.tellg();
+
+    std::vector<StringValueType> sample(
+        static_cast<std::vector<StringValueType>::size_type>(
+            DialectSampleSize));
+    const std::streamsize sampleSize = 
+        inFile.read(&sample[0], DialectSampleSize).gcount();
+    DetectDialect(&sample[0], sampleSize, encoding);
+
+    inFile.clear();
+    inFile.seekg(lastPos, std::ios::beg);
+}
+
+void ACSVParser::ClearData()
+{
+    _vVData.clear();
+    _vRowOffsets.clear();
+    _vParseErrors.clear();
+    _vQuarantinedRows.clear();
+    _removedRowCount = 0;
+    _processedRowCount = 0;
+    _vColumnCache.clear();
+    ClearArrowBuilder();
+    _vArrowTypes.clear();
+
+    CloseSpillFile();
+    _spillBeginRow = _rowsToSkip;
+    _estimatedRowCount = _rowsToSkip;
+}
+
+const bool ACSVParser::EnforceMemoryBudget()
+{
+    // The last row may still be open, so it is left alone.
+    if( _vVData.size() <= _spillBeginRow + 1 )
+        return true;
+
+    // Rows are spilled with their data types processed.
     if( _hasTypeRow )
     {
-        if( !ProcessDataTypes() )
+        if( !ProcessDataTypes(_processedRowCount, GetRowCount() - 1) )
+            return false;
+        _processedRowCount = GetRowCount() - 1;
+    }
+
+    // Account for the rows completed since the last call.
+    const DataSizeType lastRow = _vVData.size() - 1;
+    for(DataSizeType i = _estimatedRowCount; i < lastRow; ++i)
+    {
+        const RowDataType &rowData = _vVData[i];
+        _memoryInUse += sizeof(RowDataType);
+        for(RowDataSizeType j = 0; j < rowData.size(); ++j)
+            _memoryInUse += rowData[j].GetMemorySize();
+    }
+    _estimatedRowCount = lastRow;
+
+    // Half of the budget is kept for paging spilled rows back in.
+    if( _memoryInUse > _memoryBudget / 2 )
+        return SpillRows(lastRow - _spillBeginRow);
+
+    return true;
+}
+
+const bool ACSVParser::SpillRows(const DataSizeType noOfRows)
+{
+    if( !_pSpillFile )
+    {
+        std::string directory = _spillDirectory;
+        const char * const envNames[] = { "TMP", "TEMP", "TMPDIR" };
+        for(int i = 0; i < 3 && directory.empty(); ++i)
+        {
+            const char * const pValue = std::getenv(envNames[i]);
+            if( pValue )
+                directory = pValue;
+        }
+        if( directory.empty() )
+            directory = ".";
+
+        // Create a file under a name that is not in use yet. The file is 
+        // created exclusively so no other file or link is ever reused.
+        bool doesExist = true;
+        for(int i = 0; i < 1000 && doesExist; ++i)
+        {
+            std::ostringstream oss;
+            oss << directory << "/acsvparser_" 
+                << static_cast<const void *>(this) << "_" << i << ".spill";
+            if( CreateNewFile(oss.str(), doesExist) )
+                _spillFileName = oss.str();
+        }
+
+        // The file is still empty, so it doesn't need to be truncated.
+        _pSpillFile = new std::fstream(_spillFileName.c_str(), 
+            std::ios::in | std::ios::out | std::ios::binary);
+        if( _spillFileName.empty() || !*_pSpillFile )
+        {
+            CloseSpillFile();
+            _errorState = ERRORSTATE_FAILED_TO_SPILL;
+            return false;
+        }
+    }
+
+    std::vector<char> buffer;
+    for(DataSizeType firstRow = 0; firstRow < noOfRows; 
+        firstRow += SpillBlockRows)
+    {
+        const DataSizeType lastRow = 
+            std::min(firstRow + SpillBlockRows, noOfRows);
+
+        buffer.clear();
+        for(DataSizeType i = firstRow; i < lastRow; ++i)
+        {
+            const RowDataType &rowData = _vVData[_spillBeginRow + i];
+            const unsigned int noOfCols = 
+                static_cast<unsigned int>(rowData.size());
+            buffer.insert(buffer.end(), 
+                reinterpret_cast<const char *>(&noOfCols),
+                reinterpret_cast<const char *>(&noOfCols) + sizeof(noOfCols));
+            for(RowDataSizeType j = 0; j < rowData.size(); ++j)
+                rowData[j].Write(buffer);
+        }
+
+        SpillBlock block;
+        block.firstRow = _spillBeginRow + _spilledRowCount + firstRow;
+        block.rowCount = lastRow - firstRow;
+        block.size = static_cast<std::streamsize>(buffer.size());
+
+        _pSpillFile->seekp(0, std::ios::end);
+        block.offset = _pSpillFile->tellp();
+        _pSpillFile->write(&buffer[0], block.size);
+        if( !*_pSpillFile )
         {
-            _errorState = ERRORSTATE_FAILED_TO_PROCESS_TYPEDATA;
+            _errorState = ERRORSTATE_FAILED_TO_SPILL;
             return false;
         }
+
+        _vSpillBlocks.push_back(block);
+    }
+
+    _vVData.erase(_vVData.begin() + _spillBeginRow, 
+                  _vVData.begin() + _spillBeginRow + noOfRows);
+    _vRowOffsets.erase(_vRowOffsets.begin() + _spillBeginRow, 
+                       _vRowOffsets.begin() + _spillBeginRow + noOfRows);
+    _spilledRowCount += noOfRows;
+    _estimatedRowCount = _spillBeginRow;
+    _memoryInUse = 0;
+
+    return true;
+}
+
+const ACSVParser::RowDataType& ACSVParser::GetSpilledRowAt(
+    const DataSizeType actualRow) const
+{
+    // Find the block that holds the row.
+    std::vector<SpillBlock>::size_type low = 0;
+    std::vector<SpillBlock>::size_type high = _vSpillBlocks.size();
+    while( high - low > 1 )
+    {
+        const std::vector<SpillBlock>::size_type mid = (low + high) / 2;
+        if( _vSpillBlocks[mid].firstRow <= actualRow )
+            low = mid;
+        else
+            high = mid;
+    }
+    const SpillBlock &block = _vSpillBlocks[low];
+
+    std::list<CachedBlock>::iterator cacheIter = _spillCache.begin();
+    while( cacheIter != _spillCache.end() && cacheIter->blockIndex != low )
+        ++cacheIter;
+
+    if( cacheIter != _spillCache.end() )
+    {
+        // Mark the block as most recently used.
+        _spillCache.splice(_spillCache.begin(), _spillCache, cacheIter);
+    }
+    else
+    {
+        // Page the block back in.
+        std::vector<char> buffer(static_cast<std::vector<char>::size_type>(
+            block.size));
+        _pSpillFile->clear();
+        _pSpillFile->seekg(block.offset, std::ios::beg);
+        if( !_pSpillFile->read(&buffer[0], block.size) )
+        {
+            // The block is not cached, so it is read again on next access.
+            _errorState = ERRORSTATE_FAILED_TO_READ_SPILL;
+            return _emptyRow;
+        }
+
+        _spillCache.push_front(CachedBlock());
+        CachedBlock &cachedBlock = _spillCache.front();
+        cachedBlock.blockIndex = low;
+        cachedBlock.rows.resize(block.rowCount);
+        cachedBlock.size = 0;
+
+        // The rows are accounted for the same way as when they were spilled.
+        const char *pBuffer = &buffer[0];
+        for(DataSizeType i = 0; i < block.rowCount; ++i)
+        {
+            unsigned int noOfCols = 0;
+            std::memcpy(&noOfCols, pBuffer, sizeof(noOfCols));
+            pBuffer += sizeof(noOfCols);
+
+            RowDataType &rowData = cachedBlock.rows[i];
+            rowData.resize(noOfCols, TypeData(StringType()));
+            cachedBlock.size += sizeof(RowDataType);
+            for(unsigned int j = 0; j < noOfCols; ++j)
+            {
+                pBuffer = rowData[j].Read(pBuffer);
+                cachedBlock.size += rowData[j].GetMemorySize();
+            }
+        }
+
+        // Evict the least recently used blocks to stay within the budget.
+        _spillCacheSize += cachedBlock.size;
+        while( _spillCache.size() > 1 && _spillCacheSize > _memoryBudget / 2 )
+        {
+            _spillCacheSize -= _spillCache.back().size;
+            _spillCache.pop_back();
+        }
+    }
+
+    return _spillCache.front().rows[actualRow - block.firstRow];
+}
+
+void ACSVParser::CloseSpillFile()
+{
+    if( _pSpillFile )
+    {
+        _pSpillFile->close();
+        delete _pSpillFile;
+        _pSpillFile = NULL;
+        std::remove(_spillFileName.c_str());
+    }
+
+    _spillFileName.clear();
+    _vSpillBlocks.clear();
+    _spilledRowCount = 0;
+    _spillCache.clear();
+    _spillCacheSize = 0;
+    _memoryInUse = 0;
+}
+
+void ACSVParser::TypeData::Write(std::vector<char> &buffer) const
+{
+    const int type = _type;
+    const unsigned int length = static_cast<unsigned int>(_stringData.length());
+    const std::vector<char>::size_type size = buffer.size();
+    buffer.resize(size + sizeof(type) + sizeof(_rawData) + sizeof(length) + 
+                  length * sizeof(StringValueType));
+
+    char *pBuffer = &buffer[size];
+    std::memcpy(pBuffer, &type, sizeof(type));
+    pBuffer += sizeof(type);
+    std::memcpy(pBuffer, &_rawData, sizeof(_rawData));
+    pBuffer += sizeof(_rawData);
+    std::memcpy(pBuffer, &length, sizeof(length));
+    pBuffer += sizeof(length);
+    if( length )
+        std::memcpy(pBuffer, _stringData.data(), length * sizeof(StringValueType));
+}
+
+const char * ACSVParser::TypeData::Read(const char *pBuffer)
+{
+    int type = TYPE_STRING;
+    std::memcpy(&type, pBuffer, sizeof(type));
+    pBuffer += sizeof(type);
+    _type = static_cast<Type>(type);
+    std::memcpy(&_rawData, pBuffer, sizeof(_rawData));
+    pBuffer += sizeof(_rawData);
+
+    unsigned int length = 0;
+    std::memcpy(&length, pBuffer, sizeof(length));
+    pBuffer += sizeof(length);
+    _stringData.assign(reinterpret_cast<const StringValueType *>(pBuffer), 
+                       length);
+    return pBuffer + length * sizeof(StringValueType);
+}
+
+void ACSVParser::FlushPendingData(ParseState &parseState)
+{
+    if( !parseState.strPendingData.empty() )
+    {
+        if( _vVData.empty() )
+        {
+            BeginRow(parseState.startOffset);
+        }
+        _vVData.back().push_back(TypeData(parseState.strPendingData));
+        parseState.bDidFlushPendingData = true;
+    }
+}
+
+const bool ACSVParser::FinishParse(ParseState &parseState)
+{
+    FlushPendingData(parseState);
+
+    // Complete the last row unless it is the empty row that follows a 
+    // final record separator.
+    if( _shouldBuildArrow && !_vVData.empty() && !_vVData.back().empty() )
+        AppendArrowRow();
+
+    if( _hasTypeRow )
+    {
+        if( !ProcessDataTypes(_processedRowCount, GetRowCount()) )
+            return false;
+        _processedRowCount = GetRowCount();
     }
 
     return true;
@@ -203,7 +1183,7 @@ ACSVParser::TypeData ACSVParser::GetContentForHeaderAt(
     if( _hasHeaderRow )
     {
         const RowDataSizeType actualRow = row + _rowsToSkip;
-        if( _vVData.size() > actualRow)
+        if( GetTotalRowCount() > actualRow)
         {
             RowDataType::const_iterator colIter = _vVData[_headerRow].begin();
             while( colIter != _vVData[_headerRow].end() )
@@ -217,7 +1197,7 @@ ACSVParser::TypeData ACSVParser::GetContentForHeaderAt(
             {
                 const RowDataSizeType col = 
                     std::distance(_vVData[_headerRow].begin(), colIter);
-                return _vVData[actualRow][col];
+                return GetRowAt(actualRow)[col];
             }
         }
     }
@@ -225,12 +1205,11 @@ ACSVParser::TypeData ACSVParser::GetContentForHeaderAt(
     return TypeData(L"");
 }
 
-ACSVParser::Type ACSVParser::GetTypeAt(const DataSizeType row,
-    const RowDataSizeType col) const
+ACSVParser::Type ACSVParser::GetTypeAt(const RowDataSizeType col) const
 {
-    if( _hasTypeRow )
+    if( _hasTypeRow && _typeRow < _vVData.size() && 
+        col < _vVData[_typeRow].size() )
     {
-        const RowDataSizeType actualRow = row + _rowsToSkip;
         StringType typeStr = _vVData[_typeRow][col].GetString();
         // Convert typeStr to lowercase.
         std::transform(typeStr.begin(), typeStr.end(), typeStr.begin(), 
@@ -256,28 +1235,246 @@ ACSVParser::Type ACSVParser::GetTypeAt(const DataSizeType row,
     return TYPE_STRING;
 }
 
-const bool ACSVParser::ProcessDataTypes()
+const bool ACSVParser::ProcessDataTypes(const DataSizeType firstRow,
+                                        const DataSizeType lastRow)
 {
     if( _hasTypeRow )
     {
-        const DataSizeType noOfRows = GetRowCount();
-        for(DataSizeType i = 0; i < noOfRows; ++i)
+        // Nothing to process until the type row and some data rows exist.
+        if( GetRowCount() == 0 || _typeRow >= _vVData.size() )
+            return true;
+
+        // Resolve the type of each column once instead of for every cell.
+        std::vector<Type> columnTypes;
+        const RowDataSizeType noOfTypes = _vVData[_typeRow].size();
+        for(RowDataSizeType j = 0; j < noOfTypes; ++j)
+            columnTypes.push_back(GetTypeAt(j));
+
+        // Rows are independent of each other, so they are split across
+        // threads when built with OpenMP. Failed fields are only collected 
+        // here, so content without errors takes no extra work.
+        const bool shouldFailFast = (_errorPolicy == ERRORPOLICY_FAIL_FAST);
+        const bool shouldStopAtFailure = 
+            (_errorPolicy != ERRORPOLICY_NULL_CELL);
+        std::vector<std::pair<DataSizeType, RowDataSizeType> > failures;
+        const long noOfRows = static_cast<long>(lastRow) - 
+                              static_cast<long>(firstRow);
+
+        // Once more failures than allowed have been found, rows past the
+        // one that exceeds the limit are not converted. Earlier rows still
+        // are, so the failures reported are the first ones.
+        const bool hasLimit = shouldFailFast || _maxErrors;
+        const std::vector<std::pair<DataSizeType, RowDataSizeType> >::size_type 
+            maxFailures = (shouldFailFast || _vParseErrors.size() >= _maxErrors) ? 
+                          0 : _maxErrors - _vParseErrors.size();
+        // Written in the critical section only. Other threads see it 
+        // through the flushes.
+        long stopRow = noOfRows;
+#pragma omp parallel for schedule(static) if(noOfRows > ParallelRowThreshold)
+        for(long i = 0; i < noOfRows; ++i)
         {
-            const RowDataSizeType noOfCols = GetColumnCount(i);
+#pragma omp flush(stopRow)
+            if( i > stopRow )
+                continue;
+
+            const DataSizeType actualRow = firstRow + i + _rowsToSkip;
+            RowDataType &rowData = GetMemoryRowAt(actualRow);
+            const RowDataSizeType noOfCols = rowData.size();
             for(RowDataSizeType j = 0; j < noOfCols; ++j)
             {
-                TypeData& typeData = _vVData[i + _rowsToSkip][j];   
-                if( !typeData.ProcessDataType(GetTypeAt(i, j)) )
-                    return false;
+                const Type type = (j < noOfTypes) ? columnTypes[j] : TYPE_STRING;
+                // Fields may have been converted when building Arrow buffers.
+                if( rowData[j].GetType() == type )
+                    continue;
+                if( !rowData[j].ProcessDataType(type) )
+                {
+#pragma omp critical
+                    {
+                        failures.push_back(std::make_pair(actualRow, j));
+                        if( hasLimit && failures.size() > maxFailures )
+                        {
+                            std::nth_element(failures.begin(), 
+                                failures.begin() + maxFailures, 
+                                failures.end());
+                            stopRow = static_cast<long>(
+                                failures[maxFailures].first - 
+                                firstRow - _rowsToSkip);
+#pragma omp flush(stopRow)
+                        }
+                    }
+                    if( shouldStopAtFailure )
+                        break;
+                }
             }
         }
 
-        return true;
+        if( failures.empty() )
+            return true;
+
+        return HandleDataTypeErrors(failures);
     }
 
     return false;
 }
 
+const bool ACSVParser::HandleDataTypeErrors(
+    std::vector<std::pair<DataSizeType, RowDataSizeType> > &failures)
+{
+    // Threads may have found failures out of order, and past the first
+    // one that exceeds the limit.
+    std::sort(failures.begin(), failures.end());
+    if( _errorPolicy == ERRORPOLICY_FAIL_FAST )
+        failures.resize(1);
+    else if( _maxErrors && _vParseErrors.size() + failures.size() > _maxErrors )
+        failures.resize(_maxErrors - _vParseErrors.size() + 1);
+
+    for(std::vector<std::pair<DataSizeType, RowDataSizeType> >::size_type i = 0;
+        i < failures.size(); ++i)
+    {
+        const DataSizeType actualRow = failures[i].first;
+        const RowDataSizeType col = failures[i].second;
+
+        ParseError parseError;
+        parseError.row = actualRow + _removedRowCount;
+        parseError.col = col;
+        parseError.offset = _vRowOffsets[actualRow - _spilledRowCount];
+        parseError.type = GetTypeAt(col);
+        parseError.content = GetMemoryRowAt(actualRow)[col].GetString();
+        _vParseErrors.push_back(parseError);
+    }
+
+    if( _errorPolicy == ERRORPOLICY_FAIL_FAST )
+    {
+        _errorState = ERRORSTATE_FAILED_TO_PROCESS_TYPEDATA;
+        return false;
+    }
+
+    if( _maxErrors && _vParseErrors.size() > _maxErrors )
+    {
+        _errorState = ERRORSTATE_TOO_MANY_ERRORS;
+        return false;
+    }
+
+    if( _errorPolicy == ERRORPOLICY_SKIP_ROW || 
+        _errorPolicy == ERRORPOLICY_QUARANTINE_ROW )
+    {
+        // Remove the failed rows in a single pass, keeping the order of
+        // the remaining rows. Failed rows have not been spilled.
+        std::vector<std::pair<DataSizeType, RowDataSizeType> >::const_iterator
+            failure = failures.begin();
+        DataSizeType writeRow = failure->first - _spilledRowCount;
+        for(DataSizeType readRow = writeRow; readRow < _vVData.size(); ++readRow)
+        {
+            if( failure != failures.end() && 
+                failure->first - _spilledRowCount == readRow )
+            {
+                if( _errorPolicy == ERRORPOLICY_QUARANTINE_ROW )
+                {
+                    _vQuarantinedRows.push_back(RowDataType());
+                    _vQuarantinedRows.back().swap(_vVData[readRow]);
+                }
+
+                while( failure != failures.end() && 
+                       failure->first - _spilledRowCount == readRow )
+                    ++failure;
+                continue;
+            }
+
+            if( writeRow != readRow )
+            {
+                _vVData[writeRow].swap(_vVData[readRow]);
+                _vRowOffsets[writeRow] = _vRowOffsets[readRow];
+            }
+            ++writeRow;
+        }
+
+        _removedRowCount += _vVData.size() - writeRow;
+        _vVData.resize(writeRow);
+        _vRowOffsets.resize(writeRow);
+    }
+
+    return true;
+}
+
+ACSVParser::DataSizeType ACSVParser::GetColumnNonNullCount(
+    const RowDataSizeType col) const
+{
+    return GetColumnCache(col).nonNullCount;
+}
+
+const ACSVParser::ColumnCache& ACSVParser::GetColumnCache(
+    const RowDataSizeType col) const
+{
+    if( col >= _vColumnCache.size() )
+        _vColumnCache.resize(col + 1);
+
+    ColumnCache &columnCache = _vColumnCache[col];
+    if( columnCache.isValid )
+        return columnCache;
+
+    const DataSizeType noOfRows = GetRowCount();
+    columnCache.values.clear();
+    columnCache.values.reserve(noOfRows);
+
+    columnCache.nonNullCount = 0;
+
+    double value = 0.0;
+    for(DataSizeType i = 0; i < noOfRows; ++i)
+    {
+        const RowDataType &rowData = GetRowAt(i + _rowsToSkip);
+        if( col >= rowData.size() )
+            continue;
+        if( !rowData[col]._stringData.empty() )
+            ++columnCache.nonNullCount;
+        if( GetNumericValue(rowData[col], value) )
+            columnCache.values.push_back(value);
+    }
+
+    // The statistics are needed by both the stats and the histogram, so
+    // they are reduced once along with the gather.
+    columnCache.stats = ColumnStats();
+    if( !columnCache.values.empty() )
+    {
+        ComputeStats(&columnCache.values[0], 
+            static_cast<long>(columnCache.values.size()), columnCache.stats);
+    }
+
+    columnCache.isValid = true;
+    return columnCache;
+}
+
+void ACSVParser::GetColumnValues(const RowDataSizeType col, 
+    std::vector<double> &values) const
+{
+    values = GetColumnCache(col).values;
+}
+
+const bool ACSVParser::GetColumnStats(const RowDataSizeType col, 
+    ColumnStats &stats) const
+{
+    const ColumnCache &columnCache = GetColumnCache(col);
+    if( columnCache.values.empty() )
+        return false;
+
+    stats = columnCache.stats;
+    return true;
+}
+
+const bool ACSVParser::GetColumnHistogram(const RowDataSizeType col, 
+    const DataSizeType binCount, 
+    std::vector<DataSizeType> &bins) const
+{
+    const ColumnCache &columnCache = GetColumnCache(col);
+    if( columnCache.values.empty() || binCount == 0 )
+        return false;
+
+    bins.assign(binCount, 0);
+    ComputeHistogram(&columnCache.values[0], 
+        static_cast<long>(columnCache.values.size()), 
+        columnCache.stats.min, columnCache.stats.max, bins);
+    return true;
+}
+
 const ACSVParser::Encoding ACSVParser::GetEncoding(InputFileStreamType &inFile)
 {    
     const std::streampos lastPos = inFile.tellg();
@@ -288,30 +1485,41 @@ const ACSVParser::Encoding ACSVParser::GetEncoding(InputFileStreamType &inFile)
     const StringValueType bom2 = inFile.get();    
     const StringValueType bom3 = inFile.get();
 
-    Encoding encoding = ENC_UTF8;
     unsigned int bomToSkip = 0;
+    const Encoding encoding = GetEncoding(bom1, bom2, bom3, bomToSkip);
+
+    // Undo the skipping of BOM.
+    inFile.seekg(lastPos, std::ios::beg);
+
+    // Now skip the appropriate amount.
+    inFile.seekg(bomToSkip, std::ios::cur);
+
+    return encoding;
+}
+
+const ACSVParser::Encoding ACSVParser::GetEncoding(const unsigned int bom1,
+                                                   const unsigned int bom2,
+                                                   const unsigned int bom3,
+                                                   unsigned int &bomSize) const
+{
+    Encoding encoding = ENC_UTF8;
+    bomSize = 0;
     if( bom1 == 0xEF && bom2 == 0xBB && bom3 == 0xBF )
     {
-        bomToSkip = 3;
+        bomSize = 3;
         encoding = ENC_UTF8;
     }
-    if( bom1 == 0xFF && bom2 == 0xFE )
+    else if( bom1 == 0xFF && bom2 == 0xFE )
     {
-       bomToSkip = 2;
+       bomSize = 2;
        encoding = ENC_UTF16LE;
     }
     else if( bom1 == 0xFE && bom2 == 0xFF )
     {
-        bomToSkip = 2;
+        bomSize = 2;
         encoding = ENC_UTF16BE;
     }
 
-    // Undo the skipping of BOM.
-    inFile.seekg(lastPos, std::ios::beg);
-
-    // Now skip the appropriate amount.
-    inFile.seekg(bomToSkip, std::ios::cur);
-
     return encoding;    // Default encoding if no BOM is found.
 }
 
@@ -325,6 +1533,8 @@ const unsigned int ACSVParser::GetEncodingByteSize(const Encoding encoding)
         return 2;
     case ENC_UTF16BE:
         return 2;
+    case ENC_AUTODETECT:
+        return 1;   // Resolved before parsing; UTF-8 without a BOM.
     }
 
     return 1;   // Default
@@ -24,7 +24,19 @@
 
 #include <string>
 #include <sstream>
+#include <cwchar>
+#include <cwctype>
+#include <cerrno>
+#include <climits>
+#include <cfloat>
+#include <utility>
 #include <vector>
+#include <list>
+#include <iosfwd>
+
+// See ArrowCDataInterface.h
+struct ArrowSchema;
+struct ArrowArray;
 
 namespace acsvparser
 { 
@@ -45,12 +57,26 @@ namespace acsvparser
         /// in case of a parser error.
         enum ErrorState
         {
-            ERRORSTATE_FAILED_TO_OPEN_FILE          = -3,
+            ERRORSTATE_FAILED_TO_READ_SPILL         = -6,
+            ERRORSTATE_FAILED_TO_SPILL,
+            ERRORSTATE_TOO_MANY_ERRORS,
+            ERRORSTATE_FAILED_TO_OPEN_FILE,
             ERRORSTATE_FAILED_TO_ALLOCATE_BUFFER,
             ERRORSTATE_FAILED_TO_PROCESS_TYPEDATA,
             ERRORSTATE_NONE                         = 0
         };
 
+        /// Enumeration of policies that decide what happens to a row when
+        /// one of its fields cannot be converted to the data type given in
+        /// the type row.
+        enum ErrorPolicy
+        {
+            ERRORPOLICY_FAIL_FAST       = 0,    ///< Fail the whole parse.
+            ERRORPOLICY_SKIP_ROW,               ///< Drop the row.
+            ERRORPOLICY_NULL_CELL,              ///< Keep the field as TYPE_STRING.
+            ERRORPOLICY_QUARANTINE_ROW          ///< Move the row aside.
+        };
+
         /// Enumeration of supported field data types.
         enum Type
         {
@@ -63,6 +89,15 @@ namespace acsvparser
             TYPE_STRING,
         };
 
+        /// The supported character set encodings.
+        enum Encoding
+        {
+            ENC_UTF8    = 0,
+            ENC_UTF16LE,
+            ENC_UTF16BE,
+            ENC_AUTODETECT  ///< Detect the encoding from the byte order mark.
+        };
+
         /// Class that encapsulates field content data.
         class TypeData
         {
@@ -80,8 +115,59 @@ namespace acsvparser
             Type _type;
             StringType _stringData;
 
+            friend class ACSVParser;
+
+            /// Appends a binary form of the data to a buffer.
+            void Write(std::vector<char> &buffer) const;
+
+            /// Reads the data from its binary form and returns a pointer 
+            /// past it.
+            const char * Read(const char *pBuffer);
+
+            /// Indicates whether a string holds a decimal number, possibly
+            /// surrounded by white space. The C conversion routines also 
+            /// accept infinities, NaN and hexadecimal numbers.
+            static bool IsDecimal(const wchar_t *pStr, const bool isIntegral)
+            {
+                while( iswspace(*pStr) )
+                    ++pStr;
+                if( *pStr == L'+' || *pStr == L'-' )
+                    ++pStr;
+
+                bool hasDigits = false;
+                for( ; *pStr >= L'0' && *pStr <= L'9'; ++pStr)
+                    hasDigits = true;
+                if( !isIntegral && *pStr == L'.' )
+                {
+                    for( ++pStr; *pStr >= L'0' && *pStr <= L'9'; ++pStr)
+                        hasDigits = true;
+                }
+                if( !isIntegral && hasDigits && 
+                    (*pStr == L'e' || *pStr == L'E') )
+                {
+                    ++pStr;
+                    if( *pStr == L'+' || *pStr == L'-' )
+                        ++pStr;
+                    if( *pStr < L'0' || *pStr > L'9' )
+                        return false;
+                    while( *pStr >= L'0' && *pStr <= L'9' )
+                        ++pStr;
+                }
+
+                while( iswspace(*pStr) )
+                    ++pStr;
+                return hasDigits && *pStr == L'\0';
+            }
+
+            /// Returns the approximate number of bytes of memory used.
+            std::streamsize GetMemorySize() const
+            { 
+                return sizeof(TypeData) + 
+                    _stringData.capacity() * sizeof(StringValueType); 
+            }
+
         public:
-            explicit TypeData(StringType strData) : 
+            explicit TypeData(const StringType &strData) : 
             _stringData(strData),
                 _type(TYPE_STRING)
             {}
@@ -89,37 +175,81 @@ namespace acsvparser
             // Others
             /*! \fn const bool ProcessDataType(const Type type) 
              *  \brief Processes raw data based on the type passed in.                        
+                       Fails unless the whole content, apart from white 
+                       space around it, is converted. Numbers must be 
+                       decimal and finite.
              *  \param type a Type enum specifying the data type.
              *  \return true on success and false otherwise.
              */
             const bool ProcessDataType(const Type type)
             {
-                InputStringStreamType iss(_stringData);
+                // The C conversion routines are used since a string stream 
+                // takes the locale lock for every field it converts.
+                const wchar_t * const pBegin = _stringData.c_str();
+                wchar_t *pEnd = NULL;
+                if( type != TYPE_WCHAR && type != TYPE_STRING && 
+                    !IsDecimal(pBegin, type != TYPE_FLOAT && type != TYPE_DOUBLE) )
+                    return false;
+
+                errno = 0;
                 switch( type )
                 {
-                case TYPE_BOOL:                
-                    if( !(iss >> _rawData.boolData) )               
-                        return false;   
+                case TYPE_BOOL:
+                    {
+                        const long value = wcstol(pBegin, &pEnd, 10);
+                        if( pEnd == pBegin || (value != 0 && value != 1) )
+                            return false;
+                        _rawData.boolData = (value != 0);
+                    }
                     break;
                 case TYPE_WCHAR:
-                    if( !(iss >> _rawData.wcharData) )
+                    pEnd = const_cast<wchar_t *>(pBegin);
+                    while( iswspace(*pEnd) )
+                        ++pEnd;
+                    if( *pEnd == L'\0' )
                         return false;
+                    _rawData.wcharData = *pEnd++;
                     break;
-                case TYPE_UINT:                
-                    if( !(iss >> _rawData.uintData) )               
-                        return false;                   
+                case TYPE_UINT:
+                    {
+                        // wcstoul would silently negate a minus sign.
+                        const wchar_t *pSign = pBegin;
+                        while( iswspace(*pSign) )
+                            ++pSign;
+                        if( *pSign == L'-' )
+                            return false;
+
+                        const unsigned long value = wcstoul(pBegin, &pEnd, 10);
+                        if( pEnd == pBegin || errno == ERANGE || 
+                            value > UINT_MAX )
+                            return false;
+                        _rawData.uintData = static_cast<unsigned int>(value);
+                    }
                     break;
-                case TYPE_INT:                
-                    if( !(iss >> _rawData.intData) )                
-                        return false;                                   
+                case TYPE_INT:
+                    {
+                        const long value = wcstol(pBegin, &pEnd, 10);
+                        if( pEnd == pBegin || errno == ERANGE || 
+                            value < INT_MIN || value > INT_MAX )
+                            return false;
+                        _rawData.intData = static_cast<int>(value);
+                    }
                     break;
-                case TYPE_FLOAT:                
-                    if( !(iss >> _rawData.floatData) )              
-                        return false;                                   
+                case TYPE_FLOAT:
+                    {
+                        const double value = wcstod(pBegin, &pEnd);
+                        if( pEnd == pBegin || errno == ERANGE || 
+                            !(value >= -FLT_MAX && value <= FLT_MAX) )
+                            return false;
+                        _rawData.floatData = static_cast<float>(value);
+                    }
                     break;
-                case TYPE_DOUBLE:                
-                    if( !(iss >> _rawData.doubleData) )             
-                        return false;    
+                case TYPE_DOUBLE:
+                    _rawData.doubleData = wcstod(pBegin, &pEnd);
+                    if( pEnd == pBegin || errno == ERANGE || 
+                        !(_rawData.doubleData >= -DBL_MAX && 
+                          _rawData.doubleData <= DBL_MAX) )
+                        return false;
                     break;
                 case TYPE_STRING:
                     break;
@@ -127,6 +257,15 @@ namespace acsvparser
                     return false;
                 }
 
+                // Fail on content left over, for eg; "12abc" as TYPE_INT.
+                if( pEnd )
+                {
+                    while( iswspace(*pEnd) )
+                        ++pEnd;
+                    if( *pEnd != L'\0' )
+                        return false;
+                }
+
                 _type = type;
                 return true;
             }
@@ -173,13 +312,48 @@ namespace acsvparser
         /// The size type for the entire content of data.
         typedef DataType::size_type DataSizeType;
 
+        /// Describes a field that could not be converted to its data type.
+        struct ParseError
+        {
+            /// Index of the record in the parsed content, counting from 0
+            /// and including skipped rows.
+            DataSizeType    row;
+            RowDataSizeType col;
+            /// Offset of the start of the record in the parsed content, in 
+            /// bytes (in characters when parsing wide-character content).
+            std::streamoff  offset;
+            /// The data type the field failed to convert to.
+            Type            type;
+            /// The content of the field.
+            StringType      content;
+        };
+
+        /// Summary statistics over the numeric cells of a column.
+        struct ColumnStats
+        {
+            DataSizeType    count;  ///< Number of numeric cells.
+            double          sum;
+            double          min;
+            double          max;
+            double          mean;
+            ColumnStats() : count(0), sum(0.0), min(0.0), max(0.0), mean(0.0)
+            {}
+        };
+
         // Data Members
     private:
         StringValueType _separator;
         StringValueType _textDelim;
         StringValueType _recordSeparator;
         bool            _shouldAcceptEmbeddedNewlines;
-        ErrorState      _errorState;
+        bool            _shouldSkipCarriageReturns;
+        bool            _shouldDetectDialect;
+        /// Indicates whether each parsed character holds a single byte of 
+        /// UTF-8 content instead of a decoded character.
+        bool            _isByteContent;
+        bool            _shouldBuildArrow;
+        /// Also set by const accessors that fail to page spilled rows in.
+        mutable ErrorState _errorState;
         RowDataSizeType _rowsToSkip;
         RowDataSizeType _headerRow;
         RowDataSizeType _typeRow;
@@ -188,23 +362,124 @@ namespace acsvparser
         bool            _hasTypeRow;
 
         DataType        _vVData;
+        std::vector<std::streamoff> _vRowOffsets;
+
+        ErrorPolicy     _errorPolicy;
+        DataSizeType    _maxErrors;
+        std::vector<ParseError> _vParseErrors;
+        DataType        _vQuarantinedRows;
+        /// Number of rows removed by ERRORPOLICY_SKIP_ROW or 
+        /// ERRORPOLICY_QUARANTINE_ROW.
+        DataSizeType    _removedRowCount;
+        /// Number of data rows whose data types have been processed.
+        DataSizeType    _processedRowCount;
+
+        /// A block of rows that has been spilled to disk.
+        /// FOR INTERNAL USE ONLY
+        struct SpillBlock
+        {
+            DataSizeType    firstRow;
+            DataSizeType    rowCount;
+            std::streamoff  offset;
+            std::streamsize size;
+        };
+
+        /// A spilled block of rows that has been paged back in.
+        /// FOR INTERNAL USE ONLY
+        struct CachedBlock
+        {
+            std::vector<SpillBlock>::size_type  blockIndex;
+            DataType                            rows;
+            /// Estimated memory used by the rows.
+            std::streamsize                     size;
+        };
+
+        std::streamsize _memoryBudget;
+        std::string     _spillDirectory;
+        std::string     _spillFileName;
+        std::fstream   *_pSpillFile;
+        std::vector<SpillBlock> _vSpillBlocks;
+        /// Rows before this one are never spilled.
+        DataSizeType    _spillBeginRow;
+        DataSizeType    _spilledRowCount;
+        /// Estimated memory used by rows in _vVData, up to _estimatedRowCount.
+        std::streamsize _memoryInUse;
+        DataSizeType    _estimatedRowCount;
+        /// Most recently used blocks are at the front.
+        mutable std::list<CachedBlock> _spillCache;
+        mutable std::streamsize _spillCacheSize;
+        /// Returned in place of content that cannot be accessed.
+        const RowDataType _emptyRow;
+        const TypeData  _emptyContent;
+
+        /// The numeric cells of a column, gathered once for the column
+        /// kernels. FOR INTERNAL USE ONLY
+        struct ColumnCache
+        {
+            bool                isValid;
+            std::vector<double> values;
+            ColumnStats         stats;
+            /// Number of non-empty cells, numeric or not.
+            DataSizeType        nonNullCount;
+            ColumnCache() : isValid(false), nonNullCount(0) {}
+        };
+
+        /// Indexed by column. Cleared whenever rows are parsed.
+        mutable std::vector<ColumnCache> _vColumnCache;
+
+        /// Arrow buffers built while parsing. See ACSVParserArrow.cpp.
+        /// FOR INTERNAL USE ONLY
+        struct ArrowBuilder;
+        ArrowBuilder   *_pArrowBuilder;
+        /// Types of the columns fixed by the first export that held them.
+        std::vector<Type> _vArrowTypes;
 
         /// Stores state of the parser when parsing buffered content from file.
         /// FOR INTERNAL USE ONLY
         struct ParseState
         {
             bool bDidBeginTextDelim;
-            ParseState() : bDidBeginTextDelim(false)
+            /// Indicates whether the buffer ended with a text delimiter 
+            /// inside delimited text, which is either escaped or closes the
+            /// text depending on the start of the next buffer.
+            bool bIsTextDelimPending;
+            /// Field content that has not been terminated by a separator 
+            /// or record separator yet.
+            StringType strPendingData;
+            /// Indicates whether strPendingData was pushed into the last row
+            /// at the end of an incremental parse.
+            bool bDidFlushPendingData;
+            /// Indicates whether a text delimiter has been found. Until then
+            /// content is scanned without tracking text delimiters.
+            bool bDidFindTextDelim;
+            /// Indicates whether the buffer ended in the middle of a 
+            /// two byte character, whose first byte is then kept in 
+            /// pendingByte.
+            bool bHasPendingByte;
+            StringValueType pendingByte;
+            /// Offset of the start of the content.
+            std::streamoff startOffset;
+            /// Offset of the start of the buffer being parsed.
+            std::streamoff offset;
+            ParseState() : bDidBeginTextDelim(false), 
+                bIsTextDelimPending(false),
+                bDidFlushPendingData(false),
+                bDidFindTextDelim(false),
+                bHasPendingByte(false),
+                pendingByte(0),
+                startOffset(0),
+                offset(0)
             {}
         };
 
-        /// The supported character set encodings.
-        enum Encoding
-        {
-            ENC_UTF8    = 0,
-            ENC_UTF16LE,
-            ENC_UTF16BE
-        };
+        /// Stores state of the parser between calls to ParseFileIncremental.
+        /// FOR INTERNAL USE ONLY
+        std::string     _tailFileName;
+        std::streamoff  _tailOffset;
+        Encoding        _tailEncoding;
+        ParseState      _tailState;
+        /// Leading content of the file, used to detect a replaced file.
+        StringType      _tailSignature;
 
     public:
         // Constructor / Destructor
@@ -213,15 +488,38 @@ namespace acsvparser
             _textDelim(L'\"'),
             _recordSeparator(L'\n'),
             _shouldAcceptEmbeddedNewlines(true),
+            _shouldSkipCarriageReturns(true),
+            _shouldDetectDialect(false),
+            _isByteContent(false),
+            _shouldBuildArrow(false),
             _headerRow(0),
             _typeRow(0),
             _hasHeaderRow(false),
             _hasTypeRow(false),
             _rowsToSkip(0),
-            _errorState(ERRORSTATE_NONE)
+            _errorState(ERRORSTATE_NONE),
+            _errorPolicy(ERRORPOLICY_FAIL_FAST),
+            _maxErrors(0),
+            _removedRowCount(0),
+            _processedRowCount(0),
+            _memoryBudget(0),
+            _pSpillFile(NULL),
+            _spillBeginRow(0),
+            _spilledRowCount(0),
+            _memoryInUse(0),
+            _estimatedRowCount(0),
+            _spillCacheSize(0),
+            _emptyContent(StringType()),
+            _pArrowBuilder(NULL),
+            _tailOffset(0),
+            _tailEncoding(ENC_UTF8)
         {}
 
-        ~ACSVParser() {}
+        ~ACSVParser() 
+        { 
+            CloseSpillFile(); 
+            ClearArrowBuilder();
+        }
 
     private:
         // Copy constructor / assignment operator
@@ -230,14 +528,76 @@ namespace acsvparser
 
         // Functions
     private:  
-        const bool ParseString(const StringValueType * const pStrContent, 
+        template <typename CharType>
+        const bool ParseString(const CharType * const pStrContent, 
                                const std::streamsize bufferSize, 
                                ParseState &parseState,
                                const Encoding encoding);
-        ACSVParser::Type GetTypeAt(const DataSizeType row,
-            const RowDataSizeType col) const;   
-        const bool ProcessDataTypes();
+        template <typename CharType>
+        const bool ParseUnquotedString(const CharType * const pStrContent, 
+                                       const std::streamsize bufferSize, 
+                                       ParseState &parseState,
+                                       const Encoding encoding);
+        template <typename CharType>
+        void DetectDialect(const CharType * const pSample,
+                           const std::streamsize sampleSize,
+                           const Encoding encoding);
+        void DetectDialect(InputFileStreamType &inFile,
+                           const Encoding encoding);
+        const bool ParseStream(InputFileStreamType &inFile,
+                               const std::streamsize bufferSize,
+                               ParseState &parseState,
+                               const Encoding encoding);
+        void ClearData();
+        const DataSizeType GetTotalRowCount() const
+        { return _vVData.size() + _spilledRowCount; }
+        /// Returns a row that has not been spilled.
+        RowDataType& GetMemoryRowAt(const DataSizeType actualRow)
+        {
+            return _vVData[(_spilledRowCount && actualRow >= _spillBeginRow) ?
+                actualRow - _spilledRowCount : actualRow];
+        }
+        /// Returns any row, paging it back in if it has been spilled.
+        const RowDataType& GetRowAt(const DataSizeType actualRow) const
+        {
+            if( !_spilledRowCount || actualRow < _spillBeginRow )
+                return _vVData[actualRow];
+            if( actualRow >= _spillBeginRow + _spilledRowCount )
+                return _vVData[actualRow - _spilledRowCount];
+            return GetSpilledRowAt(actualRow);
+        }
+        const RowDataType& GetSpilledRowAt(const DataSizeType actualRow) const;
+        const bool EnforceMemoryBudget();
+        const bool SpillRows(const DataSizeType noOfRows);
+        void CloseSpillFile();
+        void BeginRow(const std::streamoff offset)
+        {
+            // The previous row is complete.
+            if( _shouldBuildArrow && !_vVData.empty() )
+                AppendArrowRow();
+            _vVData.push_back(RowDataType());
+            _vRowOffsets.push_back(offset);
+        }
+        ArrowBuilder * CreateArrowBuilder() const;
+        void BuildArrowRow(ArrowBuilder &builder, 
+                           const RowDataType &rowData) const;
+        void AppendArrowRow();
+        void ClearArrowBuilder();
+        static ACSVParser::Type InferType(const StringType &str, 
+                                          double &value);
+        void FlushPendingData(ParseState &parseState);
+        const bool FinishParse(ParseState &parseState);
+        ACSVParser::Type GetTypeAt(const RowDataSizeType col) const;
+        const bool ProcessDataTypes(const DataSizeType firstRow,
+                                    const DataSizeType lastRow);
+        const bool HandleDataTypeErrors(
+            std::vector<std::pair<DataSizeType, RowDataSizeType> > &failures);
+        const ColumnCache& GetColumnCache(const RowDataSizeType col) const;
         const Encoding GetEncoding(InputFileStreamType &inFile);
+        const Encoding GetEncoding(const unsigned int bom1,
+                                   const unsigned int bom2,
+                                   const unsigned int bom3,
+                                   unsigned int &bomSize) const;
         const unsigned int GetEncodingByteSize(const Encoding encoding);        
 
     public:
@@ -255,11 +615,47 @@ namespace acsvparser
         const StringValueType GetRecordSeparator() const 
         { return _recordSeparator; }
 
+        /// Indicates whether carriage returns are skipped when parsing.
+        /// Default value is true if not set by user.
+        const bool ShouldSkipCarriageReturns() const
+        { return _shouldSkipCarriageReturns; }
+
+        /// Indicates whether the dialect of the content is detected before 
+        /// parsing. Default value is false if not set by user.
+        const bool ShouldDetectDialect() const
+        { return _shouldDetectDialect; }
+
         /// Returns the error state of the parser.
         /// Can be queried in case of a parsing error.
         const ErrorState GetErrorState() const
         { return _errorState; }
 
+        /// Returns the policy applied to fields that cannot be converted 
+        /// to their data type.
+        /// Default value is ERRORPOLICY_FAIL_FAST if not set by user.
+        const ErrorPolicy GetErrorPolicy() const
+        { return _errorPolicy; }
+
+        /// Returns the fields that could not be converted to their data 
+        /// type during the last parse, in the order of the content.
+        const std::vector<ParseError>& GetParseErrors() const
+        { return _vParseErrors; }
+
+        /// Returns the rows moved aside by ERRORPOLICY_QUARANTINE_ROW during
+        /// the last parse. The failed fields are listed by GetParseErrors().
+        const DataType& GetQuarantinedRows() const
+        { return _vQuarantinedRows; }
+
+        /// Indicates whether Arrow buffers are built while parsing.
+        /// Default value is false if not set by user.
+        const bool ShouldBuildArrow() const
+        { return _shouldBuildArrow; }
+
+        /// Returns the memory budget for parsed rows in bytes.
+        /// Default value is 0 (no budget) if not set by user.
+        const std::streamsize GetMemoryBudget() const
+        { return _memoryBudget; }
+
         /// Indicates whether a header row was specified for 
         /// the parser.
         const bool HasHeaderRow() const
@@ -287,6 +683,69 @@ namespace acsvparser
         void SetShouldAcceptEmbeddedNewlines(const bool value) 
         { _shouldAcceptEmbeddedNewlines = value; }
 
+        /// Sets the policy applied to fields that cannot be converted to 
+        /// their data type. A parse that fails leaves the content partly
+        /// converted: fields of some rows hold their data type while the
+        /// rest are still strings. Which rows are converted depends on the
+        /// number of threads.
+        void SetErrorPolicy(const ErrorPolicy value)
+        { _errorPolicy = value; }
+
+        /// Sets the maximum number of conversion errors tolerated before the
+        /// parse fails with ERRORSTATE_TOO_MANY_ERRORS. 0 means no limit.
+        /// Conversion stops as soon as the limit is exceeded, and only the
+        /// errors up to that point are reported. Rows past the failure 
+        /// that exceeds the limit may be partly converted, depending on 
+        /// the number of threads.
+        /// Has no effect with ERRORPOLICY_FAIL_FAST.
+        void SetMaxErrors(const DataSizeType value)
+        { _maxErrors = value; }
+
+        /// Sets whether the parser should skip carriage returns.
+        void SetShouldSkipCarriageReturns(const bool value)
+        { _shouldSkipCarriageReturns = value; }
+
+        /// Sets whether the parser should detect the dialect of the content
+        /// from a sample of its head before parsing. The separator (comma, 
+        /// tab, semicolon or pipe), the text delimiter (double or single 
+        /// quote) and the record separator (LF, CRLF or CR) that are 
+        /// detected replace the values set by the user. A separator is
+        /// only detected if it occurs the same number of times on most 
+        /// lines of the sample. Detection is skipped for UTF-16 encoded 
+        /// bytes.
+        void SetShouldDetectDialect(const bool value)
+        { _shouldDetectDialect = value; }
+
+        /// Sets whether Arrow buffers are built while parsing. Each data
+        /// row is then converted and appended to the buffers of its columns
+        /// as soon as it is complete, and ExportToArrow() hands over the 
+        /// rows completed since the previous export without copying them.
+        /// The buffers are not covered by the memory budget.
+        void SetShouldBuildArrow(const bool value)
+        { _shouldBuildArrow = value; }
+
+        /// Sets the memory budget for parsed rows in bytes when parsing
+        /// files. 0 means no budget. Once the parsed rows exceed half the
+        /// budget, rows whose data types have been processed are spilled in
+        /// blocks to a temporary file. Spilled rows are paged back in when
+        /// accessed and the most recently used blocks are cached within the
+        /// other half of the budget. A row reference obtained through
+        /// operator[] or GetContentAt() is only valid until the next access
+        /// of a spilled row. Slurping is replaced by buffered parsing when
+        /// a budget is set. Since accessing a spilled row updates the cache,
+        /// a parser with spilled rows must not be read from several threads
+        /// at once. A spilled row that cannot be read back is returned 
+        /// empty and sets ERRORSTATE_FAILED_TO_READ_SPILL.
+        void SetMemoryBudget(const std::streamsize value)
+        { _memoryBudget = value; }
+
+        /// Sets the directory for temporary files of spilled rows.
+        /// Default is the directory named by the TMP, TEMP or TMPDIR
+        /// environment variable, or the current directory. The file is
+        /// created exclusively and only its owner may access it.
+        void SetSpillDirectory(const std::string &value)
+        { _spillDirectory = value; }
+
         /// Sets the row in the CSV file that contains field headers.
         void SetHeaderRow(const RowDataSizeType value) 
         { 
@@ -329,6 +788,38 @@ namespace acsvparser
         const bool ParseFile(const std::string &fileName, 
             const std::streamsize bufferSize = ACSVParser::Slurp);
 
+        /*! \fn const bool ParseFileIncremental(const std::string &fileName, 
+                const std::streamsize bufferSize = ACSVParser::Slurp) 
+         *  \brief Parses the contents of a CSV file that is being appended to.
+                   The first call parses the whole file. Subsequent calls with
+                   the same file name only parse the bytes appended since the
+                   previous call, append the new rows and process data types
+                   for the new rows only. If the file has shrunk (for eg; it
+                   was truncated) or its leading bytes have changed (for eg;
+                   it was rotated and replaced by a new file, even a longer
+                   one) it is parsed from the start.
+                   A trailing record that has not been terminated by a record
+                   separator yet is kept as TYPE_STRING until it is completed.
+         *  \param fileName the name of CSV file.
+         *  \param bufferSize the size of the internal buffer to be used
+                   when parsing. Default bufferSize is ACSVParser::Slurp which
+                   simply slurps all the new content.
+         *  \return true on success and false otherwise.
+         */
+        const bool ParseFileIncremental(const std::string &fileName, 
+            const std::streamsize bufferSize = ACSVParser::Slurp);
+
+        /*! \fn const bool HasNewData(const std::string &fileName) const
+         *  \brief Cheaply checks whether a file has changed in size, or has
+                   been replaced, since the last call to 
+                   ParseFileIncremental. Can be used to poll a
+                   file, or in response to a platform file change notification,
+                   before calling ParseFileIncremental.
+         *  \param fileName the name of CSV file.
+         *  \return true if the file has new data and false otherwise.
+         */
+        const bool HasNewData(const std::string &fileName) const;
+
         /*! \fn cconst bool ParseString(const StringType& strContent,
          *                              const Encoding encoding);
          *  \brief Parses a string as CSV content.
@@ -339,6 +830,39 @@ namespace acsvparser
         const bool ParseString(const StringType& strContent,
                                const Encoding encoding);
 
+        /*! \fn const bool ParseBuffer(const char * const pData,
+         *                              const std::streamsize length,
+         *                              const Encoding encoding = ENC_AUTODETECT)
+         *  \brief Parses a raw byte buffer as CSV content.
+                   The buffer is parsed in place and is not widened or copied
+                   first. It need not be null terminated and is not referenced
+                   after the call returns. A trailing odd byte of UTF-16 
+                   content is ignored.
+         *  \param pData the bytes to be parsed.
+         *  \param length the number of bytes to be parsed.
+         *  \param encoding the character set encoding of the bytes. 
+                   ENC_AUTODETECT detects the encoding from the byte order
+                   mark and defaults to ENC_UTF8 if there is none. A byte 
+                   order mark that matches the encoding is skipped.
+         *  \return true on success and false otherwise.
+         */
+        const bool ParseBuffer(const char * const pData,
+                               const std::streamsize length,
+                               const Encoding encoding = ENC_AUTODETECT);
+
+        /*! \fn const bool ParseBuffer(const wchar_t * const pData,
+         *                              const std::streamsize length)
+         *  \brief Parses a wide-character (for eg; UTF-16 on Windows) 
+                   buffer as CSV content.
+                   Each element of the buffer is treated as one character.
+                   The buffer is parsed in place and is not copied first.
+         *  \param pData the characters to be parsed.
+         *  \param length the number of characters to be parsed.
+         *  \return true on success and false otherwise.
+         */
+        const bool ParseBuffer(const wchar_t * const pData,
+                               const std::streamsize length);
+
         /// Resets the error state of the parser.
         void ResetState() { _errorState = ERRORSTATE_NONE; }
 
@@ -348,8 +872,8 @@ namespace acsvparser
          */
         DataSizeType GetRowCount() const 
         { 
-            return (_vVData.empty() || (_vVData.size() < _rowsToSkip)) ? 
-                0 : _vVData.size() - _rowsToSkip;       
+            return (GetTotalRowCount() < _rowsToSkip) ? 
+                0 : GetTotalRowCount() - _rowsToSkip;       
         }
 
         /*! \fn RowDataSizeType GetColumnCount(DataSizeType row) const
@@ -362,8 +886,8 @@ namespace acsvparser
          */
         RowDataSizeType GetColumnCount(DataSizeType row) const 
         { 
-            return (_vVData.empty() || (_vVData.size() <= row + _rowsToSkip)) ? 
-                0 : _vVData[row + _rowsToSkip].size();          
+            return (GetTotalRowCount() <= row + _rowsToSkip) ? 
+                0 : GetRowAt(row + _rowsToSkip).size();          
         }
 
         /*! \fn const TypeData& GetContentAt(const DataSizeType row, 
@@ -372,11 +896,15 @@ namespace acsvparser
                    column.
          *  \param row the row.
          *  \param col the column.
-         *  \return the content.
+         *  \return the content, or empty content if the row has no such 
+                    column.
          */
         const TypeData& GetContentAt(const DataSizeType row, 
             const RowDataSizeType col) const
-        { return _vVData[row + _rowsToSkip][col]; }             
+        { 
+            const RowDataType &rowData = GetRowAt(row + _rowsToSkip);
+            return (col < rowData.size()) ? rowData[col] : _emptyContent;
+        }             
 
         /*! \fn TypeData GetContentForHeaderAt(const StringType& headerStr, 
                 const RowDataSizeType row) const
@@ -389,16 +917,101 @@ namespace acsvparser
         TypeData GetContentForHeaderAt(const StringType& headerStr, 
             const RowDataSizeType row) const;
 
+        /*! \fn DataSizeType GetColumnNonNullCount(
+                const RowDataSizeType col) const
+         *  \brief Returns the number of rows that have non-empty content for
+                   a specified column. It is counted along with the 
+                   numeric cells of the column (see GetColumnValues()).
+         *  \param col the column.
+         *  \return the number of non-empty cells.
+         */
+        DataSizeType GetColumnNonNullCount(const RowDataSizeType col) const;
+
+        /*! \fn void GetColumnValues(const RowDataSizeType col, 
+                std::vector<double> &values) const
+         *  \brief Copies the numeric cells (TYPE_UINT, TYPE_INT, TYPE_FLOAT
+                   and TYPE_DOUBLE) of a column into a contiguous array.
+                   Other cells are skipped. The cells of a column are 
+                   gathered once and kept until the next parse, so the 
+                   column routines must not be called concurrently.
+         *  \param col the column.
+         *  \param values receives the values.
+         */
+        void GetColumnValues(const RowDataSizeType col, 
+            std::vector<double> &values) const;
+
+        /*! \fn const bool GetColumnStats(const RowDataSizeType col, 
+                ColumnStats &stats) const
+         *  \brief Computes the count, sum, min, max and mean of the numeric
+                   cells of a column.
+         *  \param col the column.
+         *  \param stats receives the statistics.
+         *  \return true on success and false if the column has no numeric
+                    cells.
+         */
+        const bool GetColumnStats(const RowDataSizeType col, 
+            ColumnStats &stats) const;
+
+        /*! \fn const bool GetColumnHistogram(const RowDataSizeType col, 
+                const DataSizeType binCount, 
+                std::vector<DataSizeType> &bins) const
+         *  \brief Computes a histogram of the numeric cells of a column.
+                   The bins are of equal width and span the range from the
+                   minimum to the maximum value of the column.
+         *  \param col the column.
+         *  \param binCount the number of bins.
+         *  \param bins receives the number of values in each bin.
+         *  \return true on success and false if the column has no numeric
+                    cells or binCount is 0.
+         */
+        const bool GetColumnHistogram(const RowDataSizeType col, 
+            const DataSizeType binCount, 
+            std::vector<DataSizeType> &bins) const;
+
+        /*! \fn const bool ExportToArrow(ArrowSchema * const pSchema, 
+                ArrowArray * const pArray)
+         *  \brief Exports the parsed content as an Arrow record batch using
+                   the Arrow C Data Interface (see ArrowCDataInterface.h).
+                   The batch is a struct array with one child per column.
+                   Column names are taken from the header row and column
+                   types from the type row. The types of columns without
+                   a type are inferred from the first batch that holds 
+                   them: int when all their non-empty cells are decimal 
+                   integers, double when they are decimal numbers and 
+                   string otherwise. Later batches keep these types and 
+                   their cells that do not fit are null. Strings are 
+                   exported as large UTF-8 strings
+                   with 64 bit offsets. UTF-8 content read from a file or a
+                   byte buffer is copied as is, while wide strings and 
+                   UTF-16 content are encoded.
+                   Cells missing from short rows and cells that could not be
+                   converted are null, as are empty cells of inferred 
+                   numeric columns. A trailing empty row left by a final 
+                   record separator is not exported.
+                   If SetShouldBuildArrow() was set before parsing, the 
+                   buffers built so far are handed over and the batch holds
+                   the rows completed since the previous export. Otherwise
+                   the buffers are built from all the parsed rows.
+                   The caller takes ownership of both structures and must
+                   call their release callbacks when done with them.
+         *  \param pSchema receives the schema of the batch.
+         *  \param pArray receives the data of the batch.
+         *  \return true on success and false otherwise.
+         */
+        const bool ExportToArrow(ArrowSchema * const pSchema, 
+            ArrowArray * const pArray);
+
         // Overloaded operators
         /*! \fn const RowDataType& operator[](const DataSizeType row) const
          *  \brief Overloaded operator that can be used in lieu of the 
                    GetContentAt() routine.
                    For eg; instead of saying csvParser.GetContentAt(row, col), 
                    the user can also say csvParser[row][col]
+                   A spilled row that cannot be read back is empty.
          *  \return the content.
          */
         const RowDataType& operator[](const DataSizeType row) const
-        { return _vVData[row + _rowsToSkip]; }        
+        { return GetRowAt(row + _rowsToSkip); }        
     };
 }   // namespace acsvparser
 
@@ -0,0 +1,690 @@
+
+// Copyright (c) 2011 Angelo Rohit Joseph Pulikotil
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "ACSVParser.h"
+#include "ArrowCDataInterface.h"
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <cwchar>
+#include <cerrno>
+#include <climits>
+#include <cfloat>
+
+using namespace acsvparser;
+
+namespace
+{
+    /// Buffers owned by an exported array.
+    struct ArrayData
+    {
+        std::vector<unsigned char>  validity;
+        std::vector<unsigned char>  values;
+        std::vector<int64_t>        offsets;
+        std::vector<const void *>   buffers;
+        std::vector<ArrowArray *>   children;
+    };
+
+    /// Strings owned by an exported schema.
+    struct SchemaData
+    {
+        std::string                 format;
+        std::string                 name;
+        std::vector<ArrowSchema *>  children;
+    };
+
+    void ReleaseArray(ArrowArray *pArray)
+    {
+        ArrayData * const pData = static_cast<ArrayData *>(pArray->private_data);
+        for(std::size_t i = 0; i < pData->children.size(); ++i)
+        {
+            // Children may have been moved out by the consumer.
+            ArrowArray * const pChild = pData->children[i];
+            if( pChild->release )
+                pChild->release(pChild);
+            delete pChild;
+        }
+
+        delete pData;
+        pArray->release = NULL;
+    }
+
+    void ReleaseSchema(ArrowSchema *pSchema)
+    {
+        SchemaData * const pData = 
+            static_cast<SchemaData *>(pSchema->private_data);
+        for(std::size_t i = 0; i < pData->children.size(); ++i)
+        {
+            ArrowSchema * const pChild = pData->children[i];
+            if( pChild->release )
+                pChild->release(pChild);
+            delete pChild;
+        }
+
+        delete pData;
+        pSchema->release = NULL;
+    }
+
+    /// Returns the Arrow format string for a data type.
+    const char * GetArrowFormat(const ACSVParser::Type type)
+    {
+        switch( type )
+        {
+        case ACSVParser::TYPE_BOOL:
+            return "b";
+        case ACSVParser::TYPE_UINT:
+            return "I";
+        case ACSVParser::TYPE_INT:
+            return "i";
+        case ACSVParser::TYPE_FLOAT:
+            return "f";
+        case ACSVParser::TYPE_DOUBLE:
+            return "g";
+        default:
+            return "U";     // Wide characters and strings.
+        }
+    }
+
+    /// Returns the size in bytes of a fixed width value of a data type or 
+    /// 0 for types that are not stored as fixed width values.
+    std::size_t GetValueSize(const ACSVParser::Type type)
+    {
+        switch( type )
+        {
+        case ACSVParser::TYPE_UINT:
+            return sizeof(uint32_t);
+        case ACSVParser::TYPE_INT:
+            return sizeof(int32_t);
+        case ACSVParser::TYPE_FLOAT:
+            return sizeof(float);
+        case ACSVParser::TYPE_DOUBLE:
+            return sizeof(double);
+        default:
+            return 0;
+        }
+    }
+
+    /// Indicates whether values of a data type are stored as strings.
+    inline bool IsStringType(const ACSVParser::Type type)
+    {
+        return type == ACSVParser::TYPE_STRING || 
+               type == ACSVParser::TYPE_WCHAR;
+    }
+
+    /// Sets or clears a bit of a bitmap, growing it as needed.
+    inline void SetBit(std::vector<unsigned char> &bitmap, 
+        const std::size_t index, const bool value)
+    {
+        if( bitmap.size() <= index / 8 )
+            bitmap.resize(index / 8 + 1, 0);
+        if( value )
+            bitmap[index / 8] |= static_cast<unsigned char>(1 << (index % 8));
+        else
+            bitmap[index / 8] &= static_cast<unsigned char>(~(1 << (index % 8)));
+    }
+
+    inline bool GetBit(const std::vector<unsigned char> &bitmap, 
+        const std::size_t index)
+    {
+        return index / 8 < bitmap.size() && 
+               ((bitmap[index / 8] >> (index % 8)) & 1) != 0;
+    }
+
+    /// Appends a wide string to a buffer as UTF-8.
+    void AppendUTF8(const ACSVParser::StringType &str, 
+        std::vector<unsigned char> &buffer)
+    {
+        for(ACSVParser::StringType::size_type i = 0; i < str.length(); ++i)
+        {
+            unsigned long codePoint = static_cast<unsigned long>(str[i]);
+
+            // Combine UTF-16 surrogate pairs.
+            if( codePoint >= 0xD800 && codePoint <= 0xDBFF && 
+                i + 1 < str.length() )
+            {
+                const unsigned long low = static_cast<unsigned long>(str[i + 1]);
+                if( low >= 0xDC00 && low <= 0xDFFF )
+                {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + 
+                                (low - 0xDC00);
+                    ++i;
+                }
+            }
+
+            if( codePoint < 0x80 )
+            {
+                buffer.push_back(static_cast<unsigned char>(codePoint));
+            }
+            else if( codePoint < 0x800 )
+            {
+                buffer.push_back(static_cast<unsigned char>(0xC0 | (codePoint >> 6)));
+                buffer.push_back(static_cast<unsigned char>(0x80 | (codePoint & 0x3F)));
+            }
+            else if( codePoint < 0x10000 )
+            {
+                buffer.push_back(static_cast<unsigned char>(0xE0 | (codePoint >> 12)));
+                buffer.push_back(static_cast<unsigned char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                buffer.push_back(static_cast<unsigned char>(0x80 | (codePoint & 0x3F)));
+            }
+            else
+            {
+                buffer.push_back(static_cast<unsigned char>(0xF0 | (codePoint >> 18)));
+                buffer.push_back(static_cast<unsigned char>(0x80 | ((codePoint >> 12) & 0x3F)));
+                buffer.push_back(static_cast<unsigned char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                buffer.push_back(static_cast<unsigned char>(0x80 | (codePoint & 0x3F)));
+            }
+        }
+    }
+
+    /// Appends a string to a buffer as UTF-8. Strings that hold one byte
+    /// of UTF-8 content per character are copied as is.
+    void AppendString(const ACSVParser::StringType &str, 
+        const bool isByteContent, std::vector<unsigned char> &buffer)
+    {
+        if( !isByteContent )
+        {
+            AppendUTF8(str, buffer);
+            return;
+        }
+
+        for(ACSVParser::StringType::size_type i = 0; i < str.length(); ++i)
+            buffer.push_back(static_cast<unsigned char>(str[i]));
+    }
+
+    /// Buffers of a single column that are appended to row by row.
+    struct ColumnBuilder
+    {
+        ACSVParser::Type            type;
+        /// Indicates whether the type was given by the type row.
+        bool                        isTyped;
+        /// Indicates whether the type of a column without a type is still
+        /// to be inferred, i.e. no earlier export has fixed it.
+        bool                        isInferring;
+        /// Narrowest type that holds every non-empty cell of a column
+        /// without a type.
+        ACSVParser::Type            inferredType;
+        std::size_t                 length;
+        int64_t                     nullCount;
+        std::vector<unsigned char>  validity;
+        std::vector<unsigned char>  values;
+        std::vector<int64_t>        offsets;
+        /// Values and validity of the cells as inferredType. Discarded 
+        /// once the column turns out to hold strings.
+        std::vector<double>         inferredValues;
+        std::vector<unsigned char>  inferredValidity;
+
+        ColumnBuilder() : 
+            type(ACSVParser::TYPE_STRING), 
+            isTyped(false),
+            isInferring(false),
+            inferredType(ACSVParser::TYPE_INT),
+            length(0), 
+            nullCount(0)
+        {}
+
+        /// Indicates whether Append() takes the inferred type of cells.
+        const bool NeedsInference() const
+        {
+            if( isTyped )
+                return false;
+            return isInferring ? inferredType != ACSVParser::TYPE_STRING : 
+                                 type != ACSVParser::TYPE_STRING;
+        }
+
+        /// Appends a cell and its string, or a null if pTypeData is NULL.
+        /// A cell that does not hold the type of a typed column is null too,
+        /// as is a cell of a column without a type whose inferred type, 
+        /// cellType, does not fit the type fixed by an earlier export.
+        void Append(const ACSVParser::TypeData * const pTypeData, 
+            const ACSVParser::StringType * const pStr,
+            const ACSVParser::Type cellType,
+            const double cellValue,
+            const bool isByteContent)
+        {
+            bool isValid = false;
+            if( isTyped )
+            {
+                isValid = pTypeData && 
+                    (IsStringType(type) || pTypeData->GetType() == type);
+            }
+            else if( IsStringType(type) )
+            {
+                isValid = (pTypeData != NULL);
+            }
+            else
+            {
+                isValid = pTypeData && (cellType == ACSVParser::TYPE_INT || 
+                    (cellType == ACSVParser::TYPE_DOUBLE && 
+                     type == ACSVParser::TYPE_DOUBLE));
+            }
+            SetBit(validity, length, isValid);
+            if( !isValid )
+                ++nullCount;
+
+            if( IsStringType(type) )
+            {
+                if( offsets.empty() )
+                    offsets.push_back(0);
+                if( pTypeData )
+                {
+                    AppendString(*pStr, isByteContent, values);
+                    if( isInferring )
+                        Infer(pStr->empty(), cellType, cellValue);
+                }
+                else if( isInferring )
+                {
+                    Infer(true, cellType, cellValue);
+                }
+                offsets.push_back(static_cast<int64_t>(values.size()));
+            }
+            else if( type == ACSVParser::TYPE_BOOL )
+            {
+                SetBit(values, length, isValid && pTypeData->GetBool());
+            }
+            else
+            {
+                const std::size_t valueSize = GetValueSize(type);
+                values.resize(values.size() + valueSize, 0);
+                unsigned char * const pValue = &values[values.size() - valueSize];
+                if( isValid && isTyped )
+                    SetValue(*pTypeData, pValue);
+                else if( isValid )
+                    SetInferredValue(cellValue, pValue);
+            }
+
+            ++length;
+        }
+
+        /// Narrows the inferred type of a column without a type.
+        void Infer(const bool isEmpty, const ACSVParser::Type cellType,
+            const double cellValue)
+        {
+            if( inferredType == ACSVParser::TYPE_STRING )
+                return;
+
+            if( !isEmpty )
+            {
+                if( cellType == ACSVParser::TYPE_STRING )
+                {
+                    inferredType = ACSVParser::TYPE_STRING;
+                    std::vector<double>().swap(inferredValues);
+                    std::vector<unsigned char>().swap(inferredValidity);
+                    return;
+                }
+                if( cellType == ACSVParser::TYPE_DOUBLE )
+                    inferredType = ACSVParser::TYPE_DOUBLE;
+            }
+
+            SetBit(inferredValidity, inferredValues.size(), !isEmpty);
+            inferredValues.push_back(isEmpty ? 0.0 : cellValue);
+        }
+
+        /// Copies an inferred value into a fixed width value of an 
+        /// inferred numeric type.
+        void SetInferredValue(const double value, 
+            unsigned char * const pValue) const
+        {
+            if( type == ACSVParser::TYPE_INT )
+                *reinterpret_cast<int32_t *>(pValue) = static_cast<int32_t>(value);
+            else
+                *reinterpret_cast<double *>(pValue) = value;
+        }
+
+        /// Copies the value of a cell into a fixed width value.
+        void SetValue(const ACSVParser::TypeData &typeData, 
+            unsigned char * const pValue) const
+        {
+            switch( type )
+            {
+            case ACSVParser::TYPE_UINT:
+                *reinterpret_cast<uint32_t *>(pValue) = typeData.GetUInt();
+                break;
+            case ACSVParser::TYPE_INT:
+                *reinterpret_cast<int32_t *>(pValue) = typeData.GetInt();
+                break;
+            case ACSVParser::TYPE_FLOAT:
+                *reinterpret_cast<float *>(pValue) = typeData.GetFloat();
+                break;
+            case ACSVParser::TYPE_DOUBLE:
+                *reinterpret_cast<double *>(pValue) = typeData.GetDouble();
+                break;
+            default:
+                break;
+            }
+        }
+
+        /// Replaces the strings of a column without a type by the values
+        /// of its inferred numeric type, if it has any non-empty cells.
+        void ApplyInferredType()
+        {
+            if( !isInferring )
+                return;
+            isInferring = false;
+            if( inferredType == ACSVParser::TYPE_STRING || 
+                inferredValues.empty() )
+                return;
+
+            bool hasValues = false;
+            for(std::size_t i = 0; i < length && !hasValues; ++i)
+                hasValues = GetBit(inferredValidity, i);
+            if( !hasValues )
+                return;
+
+            type = inferredType;
+            const std::size_t valueSize = GetValueSize(type);
+            std::vector<unsigned char> newValues(length * valueSize, 0);
+            nullCount = 0;
+            for(std::size_t i = 0; i < length; ++i)
+            {
+                // Empty cells become null as well.
+                const bool isValid = GetBit(validity, i) && 
+                                     GetBit(inferredValidity, i);
+                SetBit(validity, i, isValid);
+                if( !isValid )
+                {
+                    ++nullCount;
+                    continue;
+                }
+
+                SetInferredValue(inferredValues[i], 
+                    &newValues[i * valueSize]);
+            }
+
+            values.swap(newValues);
+            std::vector<int64_t>().swap(offsets);
+            std::vector<double>().swap(inferredValues);
+            std::vector<unsigned char>().swap(inferredValidity);
+        }
+
+        /// Hands the buffers over to an exported array.
+        void MoveTo(ArrayData &arrayData)
+        {
+            ApplyInferredType();
+
+            // Keep every buffer allocated even when it is empty.
+            SetBit(validity, length, false);
+            arrayData.validity.swap(validity);
+            arrayData.values.swap(values);
+            if( arrayData.values.empty() )
+                arrayData.values.reserve(1);
+
+            arrayData.buffers.push_back(
+                nullCount ? &arrayData.validity[0] : NULL);
+            if( IsStringType(type) )
+            {
+                if( offsets.empty() )
+                    offsets.push_back(0);
+                arrayData.offsets.swap(offsets);
+                arrayData.buffers.push_back(&arrayData.offsets[0]);
+            }
+            arrayData.buffers.push_back(arrayData.values.data());
+        }
+    };
+}
+
+/// Columns of the rows completed since the last export.
+struct ACSVParser::ArrowBuilder
+{
+    std::vector<ColumnBuilder>  columns;
+    /// Number of rows appended to every column.
+    std::size_t                 length;
+    /// Types of the columns given by the type row.
+    std::vector<Type>           types;
+    /// Types of the columns fixed by earlier exports.
+    std::vector<Type>           fixedTypes;
+    bool                        isByteContent;
+
+    ArrowBuilder() : length(0), isByteContent(false) {}
+
+    /// Adds a column that is null in the rows appended so far.
+    void AddColumn()
+    {
+        const std::size_t col = columns.size();
+        columns.push_back(ColumnBuilder());
+        ColumnBuilder &column = columns.back();
+        column.isTyped = (col < types.size());
+        column.isInferring = !column.isTyped && col >= fixedTypes.size();
+        if( column.isTyped )
+            column.type = types[col];
+        else if( !column.isInferring )
+            column.type = fixedTypes[col];
+        for(std::size_t i = 0; i < length; ++i)
+            column.Append(NULL, NULL, TYPE_STRING, 0.0, isByteContent);
+    }
+};
+
+ACSVParser::ArrowBuilder * ACSVParser::CreateArrowBuilder() const
+{
+    ArrowBuilder * const pBuilder = new ArrowBuilder;
+    pBuilder->isByteContent = _isByteContent;
+
+    // The type row always precedes the data rows.
+    if( _hasTypeRow && _typeRow < _vVData.size() )
+    {
+        const RowDataSizeType noOfTypes = _vVData[_typeRow].size();
+        for(RowDataSizeType col = 0; col < noOfTypes; ++col)
+            pBuilder->types.push_back(GetTypeAt(col));
+    }
+    pBuilder->fixedTypes = _vArrowTypes;
+
+    return pBuilder;
+}
+
+void ACSVParser::BuildArrowRow(ArrowBuilder &builder, 
+    const RowDataType &rowData) const
+{
+    for(RowDataSizeType col = 0; 
+        col < rowData.size() || col < builder.columns.size(); ++col)
+    {
+        if( col == builder.columns.size() )
+            builder.AddColumn();
+
+        ColumnBuilder &column = builder.columns[col];
+        if( col < rowData.size() )
+        {
+            double value = 0.0;
+            const Type cellType = column.NeedsInference() ? 
+                InferType(rowData[col]._stringData, value) : TYPE_STRING;
+            column.Append(&rowData[col], &rowData[col]._stringData, 
+                cellType, value, builder.isByteContent);
+        }
+        else
+        {
+            column.Append(NULL, NULL, TYPE_STRING, 0.0, 
+                builder.isByteContent);
+        }
+    }
+
+    ++builder.length;
+}
+
+ACSVParser::Type ACSVParser::InferType(const StringType &str, 
+    double &value)
+{
+    // Only decimal numbers are accepted, like when converting fields.
+    const wchar_t * const pBegin = str.c_str();
+    if( TypeData::IsDecimal(pBegin, true) )
+    {
+        errno = 0;
+        const long intValue = wcstol(pBegin, NULL, 10);
+        if( errno != ERANGE && intValue >= INT_MIN && intValue <= INT_MAX )
+        {
+            value = static_cast<double>(intValue);
+            return TYPE_INT;
+        }
+    }
+
+    if( TypeData::IsDecimal(pBegin, false) )
+    {
+        errno = 0;
+        value = wcstod(pBegin, NULL);
+        if( errno != ERANGE && value >= -DBL_MAX && value <= DBL_MAX )
+            return TYPE_DOUBLE;
+    }
+
+    return TYPE_STRING;
+}
+
+void ACSVParser::ClearArrowBuilder()
+{
+    delete _pArrowBuilder;
+    _pArrowBuilder = NULL;
+}
+
+void ACSVParser::AppendArrowRow()
+{
+    // Rows up to the header and type rows are not exported.
+    if( GetTotalRowCount() <= _rowsToSkip )
+        return;
+
+    if( !_pArrowBuilder )
+        _pArrowBuilder = CreateArrowBuilder();
+
+    // Convert the fields now while they are still in the cache. They are
+    // skipped when the data types of the row are processed.
+    RowDataType &rowData = _vVData.back();
+    const std::vector<Type> &types = _pArrowBuilder->types;
+    const RowDataSizeType noOfCols = std::min(rowData.size(), types.size());
+    for(RowDataSizeType col = 0; col < noOfCols; ++col)
+    {
+        if( rowData[col].GetType() != types[col] && 
+            !rowData[col].ProcessDataType(types[col]) && 
+            _errorPolicy != ERRORPOLICY_NULL_CELL )
+        {
+            // The row is removed, or the parse fails, once the data types
+            // of the row are processed.
+            return;
+        }
+    }
+
+    BuildArrowRow(*_pArrowBuilder, rowData);
+}
+
+const bool ACSVParser::ExportToArrow(ArrowSchema * const pSchema, 
+    ArrowArray * const pArray)
+{
+    if( !pSchema || !pArray )
+        return false;
+
+    // Take over the buffers built while parsing, or build them from the 
+    // parsed rows.
+    ArrowBuilder * const pBuilder = 
+        _pArrowBuilder ? _pArrowBuilder : CreateArrowBuilder();
+    _pArrowBuilder = NULL;
+    if( !_shouldBuildArrow )
+    {
+        // Don't export the empty row that follows a final record separator.
+        DataSizeType noOfRows = GetRowCount();
+        if( noOfRows > 0 && GetColumnCount(noOfRows - 1) == 0 )
+            --noOfRows;
+
+        for(DataSizeType i = 0; i < noOfRows; ++i)
+            BuildArrowRow(*pBuilder, GetRowAt(i + _rowsToSkip));
+    }
+
+    // Columns named by the header row, typed by the type row or exported
+    // before are exported even if no row has reached them.
+    RowDataSizeType noOfCols = std::max(pBuilder->columns.size(), 
+                                        _vArrowTypes.size());
+    if( _hasHeaderRow && _headerRow < _vVData.size() && 
+        _vVData[_headerRow].size() > noOfCols )
+        noOfCols = _vVData[_headerRow].size();
+    if( _hasTypeRow && _typeRow < _vVData.size() && 
+        _vVData[_typeRow].size() > noOfCols )
+        noOfCols = _vVData[_typeRow].size();
+    while( pBuilder->columns.size() < noOfCols )
+        pBuilder->AddColumn();
+
+    // The record batch is a struct array without nulls.
+    SchemaData * const pSchemaData = new SchemaData;
+    pSchemaData->format = "+s";
+    std::memset(pSchema, 0, sizeof(ArrowSchema));
+    pSchema->format = pSchemaData->format.c_str();
+    pSchema->name = pSchemaData->name.c_str();
+    pSchema->release = ReleaseSchema;
+    pSchema->private_data = pSchemaData;
+
+    ArrayData * const pArrayData = new ArrayData;
+    pArrayData->buffers.push_back(NULL);
+    std::memset(pArray, 0, sizeof(ArrowArray));
+    pArray->length = static_cast<int64_t>(pBuilder->length);
+    pArray->n_buffers = 1;
+    pArray->buffers = &pArrayData->buffers[0];
+    pArray->release = ReleaseArray;
+    pArray->private_data = pArrayData;
+
+    for(RowDataSizeType col = 0; col < noOfCols; ++col)
+    {
+        ColumnBuilder &column = pBuilder->columns[col];
+
+        // The buffers are handed over without copying them.
+        ArrayData * const pChildData = new ArrayData;
+        column.MoveTo(*pChildData);
+
+        // Later batches keep the type of the column.
+        if( col == _vArrowTypes.size() )
+            _vArrowTypes.push_back(column.type);
+
+        // Describe the column.
+        SchemaData * const pChildSchemaData = new SchemaData;
+        pChildSchemaData->format = GetArrowFormat(column.type);
+        if( _hasHeaderRow && _headerRow < _vVData.size() && 
+            col < _vVData[_headerRow].size() )
+        {
+            std::vector<unsigned char> name;
+            AppendString(_vVData[_headerRow][col].GetString(), 
+                _isByteContent, name);
+            pChildSchemaData->name.assign(name.begin(), name.end());
+        }
+
+        ArrowSchema * const pChildSchema = new ArrowSchema;
+        std::memset(pChildSchema, 0, sizeof(ArrowSchema));
+        pChildSchema->format = pChildSchemaData->format.c_str();
+        pChildSchema->name = pChildSchemaData->name.c_str();
+        pChildSchema->flags = ARROW_FLAG_NULLABLE;
+        pChildSchema->release = ReleaseSchema;
+        pChildSchema->private_data = pChildSchemaData;
+        pSchemaData->children.push_back(pChildSchema);
+
+        ArrowArray * const pChildArray = new ArrowArray;
+        std::memset(pChildArray, 0, sizeof(ArrowArray));
+        pChildArray->length = static_cast<int64_t>(column.length);
+        pChildArray->null_count = column.nullCount;
+        pChildArray->n_buffers = static_cast<int64_t>(pChildData->buffers.size());
+        pChildArray->buffers = &pChildData->buffers[0];
+        pChildArray->release = ReleaseArray;
+        pChildArray->private_data = pChildData;
+        pArrayData->children.push_back(pChildArray);
+    }
+
+    delete pBuilder;
+
+    pSchema->n_children = static_cast<int64_t>(noOfCols);
+    pArray->n_children = static_cast<int64_t>(noOfCols);
+    if( noOfCols > 0 )
+    {
+        pSchema->children = &pSchemaData->children[0];
+        pArray->children = &pArrayData->children[0];
+    }
+
+    return true;
+}